@@ -20,7 +20,7 @@ extern uint32_t _sidata, _sdata, _edata, _sbss, _ebss, _heap_start;
 
 extern const struct song_t song_pacman;
 
-uint32_t counter_frequency = 16000000/50;  /* 50 times per second */
+uint32_t counter_frequency = SYS_CLK_HZ/50;  /* 50 times per second */
 uint32_t led_state = 0x00000000;
 
 uint32_t set_irq_mask(uint32_t mask); asm (
@@ -105,7 +105,7 @@ void irq_handler(uint32_t irqs, uint32_t* regs)
 
 void main() {
 
-    reg_uart_clkdiv = 138;  // 16,000,000 / 115,200
+    reg_uart_clkdiv = UART_CLKDIV(115200);
     print("\n\nBooting..\n");
     print("Enabling IRQs..\n");
     set_irq_mask(0x00);
@@ -121,6 +121,12 @@ void main() {
     // switch to dual IO mode
     reg_spictrl = (reg_spictrl & ~0x007F0000) | 0x00400000;
 
+    // record the first 8ms of the song, from its first register write
+    // (1 in 16 samples, 62.5kHz), and dump it over the UART once full
+    audio_capture_start(AUDIO_CAPTURE_RUN | AUDIO_CAPTURE_ON_WRITE | AUDIO_CAPTURE_ONE_SHOT
+                        | AUDIO_CAPTURE_DECIMATE(16));
+    int capture_dumped = 0;
+
     print("Playing song and blinking\n");
 
     // set timer interrupt to happen 1/50th sec from now
@@ -138,6 +144,11 @@ void main() {
     uint32_t time_waster = 0;
     uint32_t sprite_pos = 0;
     while (1) {
+        if (!capture_dumped && (reg_audio_capture & AUDIO_CAPTURE_WRAPPED)) {
+          audio_capture_dump();
+          capture_dumped = 1;
+        }
+
         time_waster = time_waster + 1;
         if ((time_waster & 0x7ff) == 0x7ff) {
           /* update screen tile map offsets */
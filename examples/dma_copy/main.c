@@ -0,0 +1,70 @@
+#include <stdint.h>
+#include <uart/uart.h>
+#include <irq/irq.h>
+#include <dma/dma.h>
+#include <timer/timer.h>
+
+// Copies a block of flash into RAM with a CPU loop and then with the DMA
+// engine, counting how far the CPU gets through a loop of its own while
+// the engine works, and reports the clocks each took.
+
+#define reg_uart_clkdiv (*(volatile uint32_t*)0x02000004)
+
+#define COPY_WORDS 128
+#define FLASH_BASE ((const uint32_t *)0x00050000)   // this program
+
+uint32_t set_irq_mask(uint32_t mask); asm (
+    ".global set_irq_mask\n"
+    "set_irq_mask:\n"
+    ".word 0x0605650b\n"
+    "ret\n"
+);
+
+static uint32_t buffer[COPY_WORDS];
+static volatile int copied;
+
+static void on_copied(void) {
+  copied = 1;
+}
+
+static int check(void) {
+  for (int i = 0; i < COPY_WORDS; i++)
+    if (buffer[i] != FLASH_BASE[i])
+      return 0;
+  return 1;
+}
+
+static void report(const char *name, uint32_t clocks, int ok) {
+  print(name); print_hex(clocks, 8); print(" clocks");
+  print(ok ? "\n" : ", wrong data\n");
+}
+
+void main() {
+  reg_uart_clkdiv = UART_CLKDIV(115200);
+  set_irq_mask(~(1 << IRQ_7));   // the DMA event
+
+  while (1) {
+    for (int i = 0; i < COPY_WORDS; i++) buffer[i] = 0;
+    uint32_t start = timer_cycles();
+    for (int i = 0; i < COPY_WORDS; i++) buffer[i] = FLASH_BASE[i];
+    report("CPU copy ", timer_cycles() - start, check());
+
+    for (int i = 0; i < COPY_WORDS; i++) buffer[i] = 0;
+    copied = 0;
+    uint32_t spins = 0;
+    start = timer_cycles();
+    dma_start(0, FLASH_BASE, buffer, COPY_WORDS, DMA_COPY, on_copied);
+    while (!copied) spins++;
+    report("DMA copy ", timer_cycles() - start, check());
+    print("  the CPU looped "); print_hex(spins, 8); print(" times meanwhile\n");
+
+    for (int i = 0; i < COPY_WORDS; i++) buffer[i] = 0;
+    start = timer_cycles();
+    dma_start(1, FLASH_BASE, buffer, COPY_WORDS, DMA_COPY, 0);
+    dma_wait(1);
+    report("DMA wait ", timer_cycles() - start, check());
+
+    uint32_t pause = timer_now();
+    while (timer_now() - pause < 1000000);
+  }
+}
@@ -0,0 +1,138 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <uart/uart.h>
+#include <flash/flash_mode.h>
+
+// Reports the memory mapped flash read speed in each spimemio mode, and the
+// mode flash_select_mode() picks.
+
+#define reg_uart_clkdiv (*(volatile uint32_t*)0x02000004)
+
+#define CLK_KHZ (SYS_CLK_HZ / 1000)
+
+#define BENCH_WORDS 1024
+#define FLASH_BASE 0x00050000
+#define FLASH_RANDOM_MASK 0x0000fffc   // 64KBytes
+#define SRAM_BASE 0x00000000
+#define SRAM_RANDOM_MASK 0x00000ffc    // 4KBytes
+
+// bench.S
+extern uint32_t bench_worker_begin, bench_worker_end;
+
+static const struct {
+  const char *name;
+  uint32_t mode;
+} modes[] = {
+  { "single       ", FLASH_MODE_SINGLE },
+  { "dual         ", FLASH_MODE_DUAL },
+  { "dual-crm     ", FLASH_MODE_DUAL | FLASH_MODE_CONT },
+  { "quad         ", FLASH_MODE_QUAD },
+  { "quad-crm     ", FLASH_MODE_QUAD | FLASH_MODE_CONT },
+  { "quad-ddr     ", FLASH_MODE_QUAD_DDR },
+  { "quad-ddr-crm ", FLASH_MODE_QUAD_DDR | FLASH_MODE_CONT },
+};
+
+uint32_t set_irq_mask(uint32_t mask); asm (
+    ".global set_irq_mask\n"
+    "set_irq_mask:\n"
+    ".word 0x0605650b\n"
+    "ret\n"
+);
+
+void irq_handler(uint32_t irqs, uint32_t* regs) { }
+
+// no divide instruction, and no libgcc
+static uint32_t udiv(uint32_t n, uint32_t d) {
+  uint32_t q = 0, r = 0;
+  for (int i = 31; i >= 0; i--) {
+    r = (r << 1) | ((n >> i) & 1);
+    if (r >= d) {
+      r -= d;
+      q |= 1 << i;
+    }
+  }
+  return q;
+}
+
+// right aligned in a field of width characters
+static void print_dec(uint32_t v, int width) {
+  char buffer[10];
+  int n = 0;
+  do {
+    buffer[n++] = '0' + v - 10 * udiv(v, 10);
+    v = udiv(v, 10);
+  } while (v);
+  while (width-- > n) putchar(' ');
+  while (n) putchar(buffer[--n]);
+}
+
+static uint32_t bench(uint32_t base, uint32_t random_mask) {
+  uint32_t func[&bench_worker_end - &bench_worker_begin];
+
+  uint32_t *src_ptr = &bench_worker_begin;
+  uint32_t *dst_ptr = func;
+  while (src_ptr != &bench_worker_end) *(dst_ptr++) = *(src_ptr++);
+
+  return ((uint32_t(*)(uint32_t, uint32_t, uint32_t))func)(base, BENCH_WORDS, random_mask);
+}
+
+// clocks, and KBytes/s at SYS_CLK_HZ
+static void print_result(uint32_t clocks) {
+  print_dec(clocks, 7);
+  print(" ");
+  print_dec(udiv(BENCH_WORDS * 4 * CLK_KHZ, clocks), 6);
+  print("   ");
+}
+
+static void print_mode(uint32_t mode) {
+  for (int i = sizeof(modes) / sizeof(modes[0]) - 1; i >= 0; i--)
+    if ((mode & 0x00700000) == modes[i].mode) {
+      print(modes[i].name);
+      break;
+    }
+  print("dummy ");
+  print_dec((mode >> 16) & 15, 2);
+}
+
+void main() {
+  reg_uart_clkdiv = UART_CLKDIV(115200);
+
+  set_irq_mask(0xff);
+
+  print("\nflash read benchmark, ");
+  print_dec(BENCH_WORDS, 4);
+  print(" words\n");
+  print("mode          dummy    sequential           random\n");
+  print("                     clocks   KB/s    clocks   KB/s\n");
+
+  print("sram             ");
+  print_result(bench(SRAM_BASE, 0));
+  print_result(bench(SRAM_BASE, SRAM_RANDOM_MASK));
+  print("\n");
+
+  flash_enable_quad();
+
+  for (int i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+    print(modes[i].name);
+
+    uint32_t dummy = 0;
+    while (dummy < 16 && !flash_mode_probe(modes[i].mode | FLASH_DUMMY(dummy)))
+      dummy++;
+    if (dummy == 16) {
+      print(" not stable\n");
+      continue;
+    }
+
+    print_dec(dummy, 2);
+    print("  ");
+    print_result(bench(FLASH_BASE, 0));
+    print_result(bench(FLASH_BASE, FLASH_RANDOM_MASK));
+    print("\n");
+  }
+
+  print("selected: ");
+  print_mode(flash_select_mode());
+  print("\n");
+
+  while (1);
+}
@@ -2,6 +2,7 @@
 #include <stdbool.h>
 #include <uart/uart.h>
 #include <button/button.h>
+#include <delay/delay.h>
 
 #include "font.h"
 
@@ -66,10 +67,6 @@ uint32_t set_irq_mask(uint32_t mask); asm (
 
 void irq_handler(uint32_t irqs, uint32_t* regs) { }
 
-void delay(uint32_t n) {
-  for (uint32_t i = 0; i < (n << 6); i++) asm volatile ("");
-}
-
 void send_cmd(uint8_t r) {
 	reg_dc = 0;
 	reg_xfer = r;
@@ -82,7 +79,7 @@ void send_data(uint8_t d) {
 
 void reset() {
 	reg_rst = 0;
-        delay(2);
+        delay_ms(2);
 	reg_rst = 1;
         for(int i=0;i<3;i++) reg_xfer = 0x00;
 }
@@ -90,11 +87,11 @@ void reset() {
 void init() {
 	reset();
 
-        delay(200);
+        delay_ms(200);
 
         send_cmd(ILI9341_SOFTRESET);
 
-        delay(50);
+        delay_ms(50);
 
         send_cmd(ILI9341_DISPLAYOFF);
 
@@ -126,11 +123,11 @@ void init() {
 
         send_cmd(ILI9341_SLEEPOUT);
 
-        delay(150);
+        delay_ms(150);
 
 	send_cmd(ILI9341_DISPLAYON); 
 
-        delay(500);
+        delay_ms(500);
 }
 
 void set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
@@ -522,7 +519,7 @@ char games[MAX_GAMES][9];
 int num_games;
 
 void main() {
-    reg_uart_clkdiv = 139;
+    reg_uart_clkdiv = UART_CLKDIV(115200);
 
     set_irq_mask(0xff);
 
@@ -650,6 +647,6 @@ void main() {
         drawText(80, 80 + (index*20), "* ", 0xD0B7, 0x6E5D);
       }
 
-      delay(5);
+      delay_ms(5);
     } 
 }
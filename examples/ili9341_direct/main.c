@@ -195,7 +195,7 @@ void drawText(int16_t x, int16_t y, const char *text, uint16_t c, uint16_t bc) {
 }
 
 void main() {
-    reg_uart_clkdiv = 139;
+    reg_uart_clkdiv = UART_CLKDIV(115200);
 
     set_irq_mask(0xff);
 
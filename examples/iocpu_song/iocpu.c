@@ -0,0 +1,55 @@
+// Runs on the IO coprocessor: plays the song at 50Hz and reads the
+// controller in between, reporting both through the mailbox.
+
+#include <stdint.h>
+#include <songplayer/songplayer.h>
+#include <nunchuk/nunchuk.h>
+#include "mailbox.h"
+
+#define CLOCKS_PER_TICK (SYS_CLK_HZ/50)
+
+extern const struct song_t song_pacman;
+
+static void wait_clocks(uint32_t clocks) {
+  uint32_t start = iocpu_cycles();
+  while (iocpu_cycles() - start < clocks);
+}
+
+void main() {
+  mailbox->ticks = 0;
+  mailbox->polls = 0;
+  mailbox->effect = 0;
+
+  // initialise the classic controller
+  i2c_write(0xF0, 0x55);
+  wait_clocks(16000);
+  i2c_write(0xFB, 0x00);
+
+  songplayer_init(&song_pacman);
+  songplayer_start(0);
+
+  uint32_t next_tick = iocpu_cycles() + CLOCKS_PER_TICK;
+  while (1) {
+    if ((int32_t)(iocpu_cycles() - next_tick) >= 0) {
+      next_tick += CLOCKS_PER_TICK;
+      uint32_t effect = mailbox->effect;
+      if (effect) {
+        songplayer_trigger_effect(effect - 1);
+        mailbox->effect = 0;
+      }
+      songplayer_tick();
+      mailbox->ticks++;
+    } else {
+      // a read takes well under a tick, so the song stays on time
+      i2c_send_reg(0x00);
+      uint32_t jx = i2c_read();
+      uint32_t jy = i2c_read();
+      i2c_read();
+      i2c_read();
+      i2c_read();
+      uint32_t buttons = i2c_read();
+      mailbox->joystick = jx | (jy << 8) | (buttons << 16);
+      mailbox->polls++;
+    }
+  }
+}
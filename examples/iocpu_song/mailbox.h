@@ -0,0 +1,18 @@
+#ifndef __MAILBOX_H__
+#define __MAILBOX_H__
+
+#include <stdint.h>
+#include <iocpu/iocpu.h>
+
+// the shared RAM, as both programs see it
+struct mailbox_t {
+  uint32_t ticks;         // song ticks played (coprocessor writes)
+  uint32_t polls;         // controller reads done (coprocessor writes)
+  uint32_t joystick;      // last read: x in bits 0-7, y in 8-15, buttons in 16-23
+  uint32_t effect;        // bar number + 1 to play as a sound effect (main
+                          // CPU writes, coprocessor clears when started)
+};
+
+#define mailbox ((volatile struct mailbox_t *)IOCPU_SHARED)
+
+#endif
@@ -0,0 +1,48 @@
+#include <stdint.h>
+#include <uart/uart.h>
+#include <iocpu/iocpu.h>
+#include "mailbox.h"
+
+#define reg_spictrl (*(volatile uint32_t*)0x02000000)
+#define reg_uart_clkdiv (*(volatile uint32_t*)0x02000004)
+
+uint32_t set_irq_mask(uint32_t mask); asm (
+    ".global set_irq_mask\n"
+    "set_irq_mask:\n"
+    ".word 0x0605650b\n"
+    "ret\n"
+);
+
+void irq_handler(uint32_t irqs, uint32_t* regs) { }
+
+void main() {
+    reg_uart_clkdiv = UART_CLKDIV(115200);
+    set_irq_mask(0xff);
+
+    // switch to dual IO mode
+    reg_spictrl = (reg_spictrl & ~0x007F0000) | 0x00400000;
+
+    print("Starting the IO coprocessor..\n");
+    iocpu_start();
+
+    // the song and the controller are the coprocessor's; all this CPU does
+    // is report, and play a sound effect each time the buttons change
+    uint32_t last_ticks = 0;
+    uint32_t last_buttons = 0;
+    while (1) {
+        uint32_t ticks = mailbox->ticks;
+        if (ticks - last_ticks >= 50) {
+          last_ticks = ticks;
+          uint32_t joystick = mailbox->joystick;
+          print("ticks "); print_hex(ticks, 8);
+          print(" polls "); print_hex(mailbox->polls, 8);
+          print(" joystick "); print_hex(joystick, 6);
+          print("\n");
+
+          uint32_t buttons = joystick >> 16;
+          if (buttons != last_buttons && mailbox->effect == 0)
+            mailbox->effect = 1;  // bar 0
+          last_buttons = buttons;
+        }
+    }
+}
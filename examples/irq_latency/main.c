@@ -0,0 +1,90 @@
+#include <stdint.h>
+#include <uart/uart.h>
+#include <irq/irq.h>
+
+// Measures the clocks from an interrupt being raised to the first
+// instruction of its handler, through irq_vectors and through irq_handler().
+//
+// The interrupt is an ebreak (IRQ_EBREAK), raised at a known point, and the
+// picorv32 timer counts the clocks: it is started just before the ebreak and
+// stopped by the handler's first instruction.  The clocks two back to back
+// timer instructions take are subtracted.
+
+#define reg_uart_clkdiv (*(volatile uint32_t*)0x02000004)
+
+#define TIMER_START 0x7fffffff
+
+volatile uint32_t timer_left;
+
+uint32_t set_irq_mask(uint32_t mask); asm (
+    ".global set_irq_mask\n"
+    "set_irq_mask:\n"
+    ".word 0x0605650b\n"
+    "ret\n"
+);
+
+// The handler: stop the timer, keep the count left
+void latency_handler(); asm (
+    ".pushsection .ramfunc, \"ax\"\n"
+    ".global latency_handler\n"
+    "latency_handler:\n"
+    ".word 0x0a00628b\n"       // timer t0, zero
+    "la t1, timer_left\n"
+    "sw t0, 0(t1)\n"
+    "ret\n"
+    ".popsection\n"
+);
+
+// also used for the pending interrupts without a vector
+asm (
+    ".global irq_handler\n"
+    ".set irq_handler, latency_handler\n"
+);
+
+// Start the timer and raise IRQ_EBREAK
+void raise_ebreak(); asm (
+    ".pushsection .ramfunc, \"ax\"\n"
+    ".global raise_ebreak\n"
+    "raise_ebreak:\n"
+    "li t0, 0x7fffffff\n"
+    ".word 0x0a02e00b\n"       // timer zero, t0
+    "ebreak\n"
+    "ret\n"
+    ".popsection\n"
+);
+
+// Start and stop the timer, returns the count left
+uint32_t timer_back_to_back(); asm (
+    ".pushsection .ramfunc, \"ax\"\n"
+    ".global timer_back_to_back\n"
+    "timer_back_to_back:\n"
+    "li t0, 0x7fffffff\n"
+    ".word 0x0a02e00b\n"       // timer zero, t0
+    ".word 0x0a00650b\n"       // timer a0, zero
+    "ret\n"
+    ".popsection\n"
+);
+
+void main() {
+  reg_uart_clkdiv = UART_CLKDIV(115200);
+  set_irq_mask(~(1 << IRQ_EBREAK));
+
+  uint32_t overhead = TIMER_START - timer_back_to_back();
+
+  irq_set_vector(IRQ_EBREAK, latency_handler);
+  raise_ebreak();
+  uint32_t vector_clocks = TIMER_START - timer_left - overhead;
+
+  irq_set_vector(IRQ_EBREAK, 0);
+  raise_ebreak();
+  uint32_t handler_clocks = TIMER_START - timer_left - overhead;
+
+  print("\nIRQ latency, clocks (hex)\n");
+  print("irq_vectors:   ");
+  print_hex(vector_clocks, 4);
+  print("\nirq_handler(): ");
+  print_hex(handler_clocks, 4);
+  print("\n");
+
+  while (1);
+}
@@ -24,7 +24,7 @@ void delay(uint32_t n) {
 }
 
 void main() {
-    reg_uart_clkdiv = 139;
+    reg_uart_clkdiv = UART_CLKDIV(115200);
 
     set_irq_mask(0xff);
 
@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <uart/uart.h>
+#include <delay/delay.h>
 #include "font.h"
 
 // a pointer to this is a null pointer, but the compiler does not
@@ -34,15 +35,11 @@ uint32_t set_irq_mask(uint32_t mask); asm (
 
 void irq_handler(uint32_t irqs, uint32_t* regs) { }
 
-void delay(uint32_t n) {
-  for (uint32_t i = 0; i < n; i++) asm volatile ("");
-}
-
 void reset() {
 	reg_rst = 1;
-        delay(20000);
+        delay_ms(310);
 	reg_rst = 0;
-        delay(200000);
+        delay_ms(3100);
 	reg_rst = 1;
 }
 
@@ -168,7 +165,7 @@ void drawText(int16_t x, int16_t y, const char *text, int16_t c) {
 }
 
 void main() {
-    reg_uart_clkdiv = 139;
+    reg_uart_clkdiv = UART_CLKDIV(115200);
 
     set_irq_mask(0xff);
 
@@ -496,7 +496,7 @@ void drawText(int16_t x, int16_t y, const char *text, int16_t c) {
 }
 
 void main() {
-    reg_uart_clkdiv = 139;
+    reg_uart_clkdiv = UART_CLKDIV(115200);
 
     set_irq_mask(0xff);
 
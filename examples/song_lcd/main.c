@@ -20,7 +20,7 @@ extern uint32_t _sidata, _sdata, _edata, _sbss, _ebss, _heap_start;
 
 extern const struct song_t song_pacman;
 
-uint32_t counter_frequency = 16000000/50;  /* 50 times per second */
+uint32_t counter_frequency = SYS_CLK_HZ/50;  /* 50 times per second */
 uint32_t led_state = 0x00000000;
 
 uint32_t set_irq_mask(uint32_t mask); asm (
@@ -105,7 +105,7 @@ void irq_handler(uint32_t irqs, uint32_t* regs)
 
 void main() {
 
-    reg_uart_clkdiv = 138;  // 16,000,000 / 115,200
+    reg_uart_clkdiv = UART_CLKDIV(115200);
     print("\n\nBooting..\n");
     print("Enabling IRQs..\n");
     set_irq_mask(0x00);
@@ -5,14 +5,29 @@
 #include <video/video.h>
 #include <songplayer/songplayer.h>
 #include <uart/uart.h>
+#include <math/math.h>
+#include <pcpi/pcpi.h>
 #include <sine_table/sine_table.h>
 #include <nunchuk/nunchuk.h>
+#include <flash/flash_cache.h>
+#include <ramfunc/ramfunc.h>
+#include <irq/irq.h>
+#include <delay/delay.h>
+#include <timer/timer.h>
+#include <ramcheck/ramcheck.h>
+#include <boot/boot.h>
+#ifdef perf
+#include <perf/perf.h>
+#endif
 
 #include "graphics_data.h"
 
 //#define debug 1
 #define diag 1
 
+// pacman and the ghosts take one step per game tick, timed by -Dtimer
+#define TICK_US 10000
+
 #define abs(x) ((x) < 0 ? -(x) : (x))
 
 // a pointer to this is a null pointer, but the compiler does not
@@ -232,7 +247,7 @@ extern const struct song_t song_pacman;
 #define CLYDE_TARGET_X 0
 #define CLYDE_TARGET_Y 13
 
-const uint32_t counter_frequency = 16000000/50;  /* 50 times per second */
+const uint32_t counter_frequency = SYS_CLK_HZ/50;  /* 50 times per second */
 
 const uint8_t  ghost_colour[] = {CYAN, MAGENTA, RED, GREEN};
 const uint8_t power_pill_x[] = {POWER_PILL1_X, POWER_PILL2_X, 
@@ -269,30 +284,24 @@ uint32_t set_irq_mask(uint32_t mask); asm (
     "ret\n"
 );
 
-// Set the timer counter
+// Set the timer counter (in RAM, as the interrupt handler calls it)
 uint32_t set_timer_counter(uint32_t val); asm (
+    ".pushsection .ramfunc, \"ax\"\n"
     ".global set_timer_counter\n"
     "set_timer_counter:\n"
     ".word 0x0a05650b\n"
     "ret\n"
+    ".popsection\n"
 );
 
-// Interrupt handling used for playing audio
-void irq_handler(uint32_t irqs, uint32_t* regs)
+// Timer interrupt, used for playing audio
+RAMFUNC void timer_irq()
 {
-  /* timer IRQ */
-  if ((irqs & 1) != 0) {
-    // retrigger timer
-    set_timer_counter(counter_frequency);
-
-    // Play song
-    songplayer_tick();
-  }
-}
+  // retrigger timer
+  set_timer_counter(counter_frequency);
 
-// Delay a few clock cycles - used by Nunchuk code
-void delay(uint32_t n) {
-  for (uint32_t i = 0; i < n; i++) asm volatile ("");
+  // Play song
+  songplayer_tick();
 }
 
 // Set up the player selection start screen
@@ -615,23 +624,13 @@ void show_lives() {
   }
 }
 
-const int divisor[] = {10000,1000,100,10};
-
 // Display score, hi-score or another numnber
 void show_score(int x, int y, int score) {
-  int s = score;
+  uint32_t digits = math_bcd(score);
   bool blank = true;
   for(int i=0; i<5; i++) {
-    int d = 0;
-    if (i == 4) d = s;
-    else {
-      int div = divisor[i];
-      while (s >= div) {
-        s -= div;
-        d++;
-      } 
-      if (d !=0) blank = false;
-    }
+    int d = (digits >> ((4 - i) << 2)) & 0xf;
+    if (d !=0) blank = false;
     int tile = blank && i != 4 ? BLANK_TILE : ZERO_TILE + d;
     vid_set_tile(x+i, y, tile);
   }
@@ -775,7 +774,7 @@ bool ghost_square(uint8_t x, uint8_t y) {
 
 // Move Pacman when in auto-play
 void move_pacman() {
-  uint8_t valid = 0, num = 0;
+  uint8_t valid = 0;
   uint8_t x = sprite_x[PACMAN];
   uint8_t y = sprite_y[PACMAN];
   uint8_t n = board[sprite_y[PACMAN]][sprite_x[PACMAN]];
@@ -783,72 +782,59 @@ void move_pacman() {
   // Find the valid moves, that avoid ghosts (unless hunting)
   if  ((n & CAN_GO_UP) && (hunting > 0 || !ghost_square(x,y-1))) {
     valid |= CAN_GO_UP;
-    num++;
   }
 
   if ((n & CAN_GO_RIGHT) && (hunting > 0 || !ghost_square(x+1,y))) {
     valid |= CAN_GO_RIGHT;
-    num++;
   }   
 
   if ((n & CAN_GO_DOWN) &&(hunting > 0 ||  !ghost_square(x,y+1))) {
     valid |= CAN_GO_DOWN;
-    num++;
   }
 
   if ((n & CAN_GO_LEFT) && (hunting > 0 || !ghost_square(x-1, y))) {
     valid |= CAN_GO_LEFT;
-    num++;
   }
 
-  uint8_t save = valid, save_num = num;
   // If there is more than one direction, pick one with food 
-  if (num > 1) {
+  uint8_t save = valid;
+  if (pcpi_popcount(valid) > 1) {
     if ((valid & CAN_GO_UP) && !(board[y-1][x] & 
          (FOOD | BIG_FOOD | FRUIT))) {
       valid &= ~CAN_GO_UP;
-      num--;
     }
     if ((valid & CAN_GO_DOWN) && !(board[y+1][x] & 
          (FOOD | BIG_FOOD | FRUIT))) {
       valid &= ~CAN_GO_DOWN;
-      num--;
     }
     if ((valid & CAN_GO_LEFT) && !(board[y][x-1] & 
          (FOOD | BIG_FOOD | FRUIT))) {
       valid &= ~CAN_GO_LEFT;
-      num--;
     }
     if ((valid & CAN_GO_RIGHT) && !(board[y][x+1] & 
          (FOOD | BIG_FOOD | FRUIT))) {
       valid &= ~CAN_GO_RIGHT;
-      num--;
     }
   }
 
  
   // If not one with food, avoid going back where you came from 
-  if (num == 0) {
-     valid = save;
-     num = save_num;
-        
-    if (num > 1) {     
+  if (valid == 0) {
+    valid = save;
+
+    if (pcpi_popcount(valid) > 1) {
       uint8_t ox = old2_sprite_x[PACMAN], oy = old2_sprite_y[PACMAN];
       if ((valid & CAN_GO_UP) && x == ox && y-1 == oy) {
         valid &= ~CAN_GO_UP;
-        num--;
       }
       if ((valid & CAN_GO_DOWN) && x == ox && y+1 == oy) {
         valid &= ~CAN_GO_DOWN;
-        num--;
       }
       if ((valid & CAN_GO_LEFT) && x-1 == ox && y == oy) {
         valid &= ~CAN_GO_LEFT;
-        num--;
       }
       if ((valid & CAN_GO_RIGHT) && x+1 == ox && y == oy) {
         valid &= ~CAN_GO_RIGHT;
-        num--;
       }
     }
   } 
@@ -913,7 +899,7 @@ void show_hiscore_label() {
 void get_input() {
   // Get Nunchuk data
   i2c_send_reg(0x00);
-  delay(100);
+  delay_us(1600);
 
   jx = i2c_read();
 #ifdef debug
@@ -979,7 +965,7 @@ void show_intro_screen() {
 
   show_score(INTRO_2UP_SCORE_X, INTRO_2UP_SCORE_Y, score_2up);
 
-  delay(50000);
+  delay_ms(780);
  
   for(int i = 0; i < 4; i++) {
     setup_intro_tiles(7 + 2*i, 9 + 2*i); 
@@ -987,13 +973,13 @@ void show_intro_screen() {
     vid_enable_sprite(i+1, 1);
     get_input();
     if (buttons == 2) break;
-    delay(50000);
+    delay_ms(780);
   }
 
 
   if (buttons != 2) {
     setup_intro_tiles(15, 30); 
-    delay(50000);
+    delay_ms(780);
 
     // Place the pac-dot
     vid_set_tile(5,25, 28);
@@ -1016,11 +1002,11 @@ void show_intro_screen() {
       get_input();
       if (buttons == 2) break;
 
-      delay(10000);
+      delay_ms(160);
     }
     
     if (buttons != 2) {
-      delay(50000);
+      delay_ms(780);
   
       // Remove the pac-dot
       vid_set_tile(5,25,BLANK_TILE);
@@ -1039,20 +1025,20 @@ void show_intro_screen() {
           vid_enable_sprite(PACMAN,0);
           vid_set_image_for_sprite(g, SCORE_IMAGE + g - 1);
           vid_set_sprite_colour(g, WHITE);
-          delay(10000);
+          delay_ms(160);
           vid_enable_sprite(g, 0);
           vid_enable_sprite(PACMAN, 1);
         }
-        delay(20000);
+        delay_ms(310);
       }
 
       get_input();
-      if (buttons != 2) delay(50000);
+      if (buttons != 2) delay_ms(780);
     }
   }
 
 
-  delay(50000);
+  delay_ms(780);
  
   disable_sprites(); 
   clear_screen();
@@ -1084,12 +1070,12 @@ void show_start_screen() {
       vid_set_tile(13, 30 + 13 + num_players*2, 0);  
       num_players = (num_players == 1 ? 2 : 1);
       vid_set_tile(13, 30 + 13 + num_players*2,28);  
-      delay(20000);
+      delay_ms(310);
     }
 
     if (buttons == 2) break;
 
-    delay(100);
+    delay_us(1600);
   }
 
   clear_screen();
@@ -1123,7 +1109,9 @@ void new_life() {
 
 // Main entry point
 void main() {
-  reg_uart_clkdiv = 138;  // 16,000,000 / 115,200
+  reg_uart_clkdiv = UART_CLKDIV(115200);
+  boot_print();
+  irq_set_vector(IRQ_TIMER, timer_irq);
   set_irq_mask(0x00);
 
   // Initialize the Nunchuk
@@ -1158,15 +1146,36 @@ void main() {
     new_life();
   } else show_ready();
 
-  uint32_t time_waster = 0;
+  uint32_t next_tick = timer_now();
 
   // Main loop
   while (1) {
-    time_waster = time_waster + 1;
-    if ((time_waster & 0xfff) == 0xfff) {
+    if ((int32_t)(timer_now() - next_tick) >= 0) {
+      next_tick += TICK_US;
       // Update tick counter
       tick_counter++;
 
+#ifdef debug
+      // Flash cache hit/miss counts over the last 256 ticks
+      if ((tick_counter & 0xff) == 0) {
+        print("Cache hits ");
+        print_hex(reg_flash_cache_hits, 8);
+        print(" misses ");
+        print_hex(reg_flash_cache_misses, 8);
+        print("\n");
+        flash_cache_clear_counters();
+      }
+#endif
+
+#ifdef perf
+      // where the clocks of one tick in 256 go ("make PERF=1")
+      if ((tick_counter & 0xff) == 0) perf_reset();
+      if ((tick_counter & 0xff) == 1) perf_report();
+#endif
+
+      // stack and RAM high-water marks when 'm' is sent on the UART
+      ramcheck_poll();
+
       // Wait a while. Used to show ghost kill score
       if (skip_ticks > 0) {
         skip_ticks--;
@@ -1369,7 +1378,7 @@ void main() {
         if ((sprite_x[PACMAN] == sprite_x[i+1] && 
              sprite_y[PACMAN] == sprite_y[i+1]) && !ghost_eyes[i]) {
           if (hunting > 0) {
-            score += ghost_points;
+            score = pcpi_addsat16(score, ghost_points);
             vid_set_image_for_sprite(i+1, SCORE_IMAGE + kills++);
             vid_set_sprite_colour(i+1, WHITE);
             skip_ticks = HUNT_SCORE_TICKS;
@@ -1421,7 +1430,7 @@ void main() {
          show_big_tile(sprite_x[PACMAN], sprite_y[PACMAN], 
                        BLANK_TILE, BLANK_TILE, BLANK_TILE, BLANK_TILE);
 
-         score += (n & BIG_FOOD ? BIG_FOOD_POINTS : 
+         score = pcpi_addsat16(score, n & BIG_FOOD ? BIG_FOOD_POINTS : 
                   ( n & FRUIT ? (stage == 1 ? CHERRY_POINTS : 
                                 (stage == 2 ? STRAWBERRY_POINTS : 
                                               ORANGE_POINTS)) : FOOD_POINTS));
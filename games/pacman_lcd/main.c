@@ -5,15 +5,21 @@
 #include <video/video.h>
 #include <songplayer/songplayer.h>
 #include <uart/uart.h>
+#include <math/math.h>
 #include <sine_table/sine_table.h>
 #include <nunchuk/nunchuk.h>
 #include <button/button.h>
+#include <delay/delay.h>
+#include <timer/timer.h>
 
 #include "graphics_data.h"
 
 //#define debug 1
 #define diag 1
 
+// pacman and the ghosts take one step per game tick, timed by -Dtimer
+#define TICK_US 10000
+
 #define abs(x) ((x) < 0 ? -(x) : (x))
 
 // a pointer to this is a null pointer, but the compiler does not
@@ -233,7 +239,7 @@ extern const struct song_t song_pacman;
 #define CLYDE_TARGET_X 0
 #define CLYDE_TARGET_Y 13
 
-const uint32_t counter_frequency = 16000000/50;  /* 50 times per second */
+const uint32_t counter_frequency = SYS_CLK_HZ/50;  /* 50 times per second */
 
 const uint8_t  ghost_colour[] = {CYAN, MAGENTA, RED, GREEN};
 const uint8_t power_pill_x[] = {POWER_PILL1_X, POWER_PILL2_X, 
@@ -291,11 +297,6 @@ void irq_handler(uint32_t irqs, uint32_t* regs)
   }
 }
 
-// Delay a few clock cycles - used by Nunchuk code
-void delay(uint32_t n) {
-  for (uint32_t i = 0; i < n; i++) asm volatile ("");
-}
-
 // Set up the player selection start screen
 void setup_startscreen() {
   vid_init();
@@ -616,23 +617,13 @@ void show_lives() {
   }
 }
 
-const int divisor[] = {10000,1000,100,10};
-
 // Display score, hi-score or another numnber
 void show_score(int x, int y, int score) {
-  int s = score;
+  uint32_t digits = math_bcd(score);
   bool blank = true;
   for(int i=0; i<5; i++) {
-    int d = 0;
-    if (i == 4) d = s;
-    else {
-      int div = divisor[i];
-      while (s >= div) {
-        s -= div;
-        d++;
-      } 
-      if (d !=0) blank = false;
-    }
+    int d = (digits >> ((4 - i) << 2)) & 0xf;
+    if (d !=0) blank = false;
     int tile = blank && i != 4 ? BLANK_TILE : ZERO_TILE + d;
     vid_set_tile(x+i, y, tile);
   }
@@ -952,7 +943,7 @@ void show_intro_screen() {
 
   show_score(INTRO_2UP_SCORE_X, INTRO_2UP_SCORE_Y, score_2up);
 
-  delay(50000);
+  delay_ms(780);
  
   for(int i = 0; i < 4; i++) {
     setup_intro_tiles(7 + 2*i, 9 + 2*i); 
@@ -960,13 +951,13 @@ void show_intro_screen() {
     vid_enable_sprite(i+1, 1);
     get_input();
     if (buttons & BUTTON_A) break;
-    delay(50000);
+    delay_ms(780);
   }
 
 
   if (!(buttons & BUTTON_A)) {
     setup_intro_tiles(15, 30); 
-    delay(50000);
+    delay_ms(780);
 
     // Place the pac-dot
     vid_set_tile(5,25, 28);
@@ -989,11 +980,11 @@ void show_intro_screen() {
       get_input();
       if (buttons & BUTTON_A) break;
 
-      delay(10000);
+      delay_ms(160);
     }
     
     if (!(buttons & BUTTON_A)) {
-      delay(50000);
+      delay_ms(780);
   
       // Remove the pac-dot
       vid_set_tile(5,25,BLANK_TILE);
@@ -1012,20 +1003,20 @@ void show_intro_screen() {
           vid_enable_sprite(PACMAN,0);
           vid_set_image_for_sprite(g, SCORE_IMAGE + g - 1);
           vid_set_sprite_colour(g, WHITE);
-          delay(10000);
+          delay_ms(160);
           vid_enable_sprite(g, 0);
           vid_enable_sprite(PACMAN, 1);
         }
-        delay(20000);
+        delay_ms(310);
       }
 
       get_input();
-      if (buttons  & BUTTON_A) delay(50000);
+      if (buttons  & BUTTON_A) delay_ms(780);
     }
   }
 
 
-  delay(50000);
+  delay_ms(780);
  
   disable_sprites(); 
   clear_screen();
@@ -1057,12 +1048,12 @@ void show_start_screen() {
       vid_set_tile(13, 30 + 13 + num_players*2, 0);  
       num_players = (num_players == 1 ? 2 : 1);
       vid_set_tile(13, 30 + 13 + num_players*2,28);  
-      delay(20000);
+      delay_ms(310);
     }
 
     if (buttons & BUTTON_A) break;
 
-    delay(100);
+    delay_us(1600);
   }
 
   clear_screen();
@@ -1096,7 +1087,7 @@ void new_life() {
 
 // Main entry point
 void main() {
-  reg_uart_clkdiv = 138;  // 16,000,000 / 115,200
+  reg_uart_clkdiv = UART_CLKDIV(115200);
   set_irq_mask(0x00);
 
   // Default high score
@@ -1128,12 +1119,12 @@ void main() {
     new_life();
   } else show_ready();
 
-  uint32_t time_waster = 0;
+  uint32_t next_tick = timer_now();
 
   // Main loop
   while (1) {
-    time_waster = time_waster + 1;
-    if ((time_waster & 0xfff) == 0xfff) {
+    if ((int32_t)(timer_now() - next_tick) >= 0) {
+      next_tick += TICK_US;
       // Update tick counter
       tick_counter++;
 
@@ -5,8 +5,12 @@
 #include <video/video.h>
 #include <songplayer/songplayer.h>
 #include <uart/uart.h>
+#include <math/math.h>
 #include <sine_table/sine_table.h>
 #include <nunchuk/nunchuk.h>
+#include <delay/delay.h>
+#include <timer/timer.h>
+#include <log/log.h>
 
 #include "graphics_data.h"
 
@@ -21,6 +25,7 @@ extern uint32_t sram;
 #define MAX_SPEED 16 
 #define GRAVITY 4
 #define JUMP_SPEED 24
+#define TICK_US 5000   // movement, scrolling and the clock advance each tick
 #define DEBOUNCE_TICKS 10
 
 #define BLANK_TILE 0
@@ -61,7 +66,7 @@ extern uint32_t sram;
 
 const struct song_t song_pacman;
 
-uint32_t counter_frequency = 16000000/50;  /* 50 times per second */
+uint32_t counter_frequency = SYS_CLK_HZ/50;  /* 50 times per second */
 
 uint16_t score, coins, offset;
 uint32_t game_start, time_left;
@@ -173,38 +178,20 @@ void irq_handler(uint32_t irqs, uint32_t* regs)
   }
 }
 
-const int divisor[] = {10000,1000,100,10};
-
 // Display score, hi-score or another numnber
 void show_score(int x, int y, int score) {
-  int s = score;
+  uint32_t digits = math_bcd(score);
   for(int i=0; i<5; i++) {
-    int d = 0;
-    if (i == 4) d = s;
-    else {
-      int div = divisor[i];
-      while (s >= div) {
-        s -= div;
-        d++;
-      } 
-    }
+    int d = (digits >> ((4 - i) << 2)) & 0xf;
     vid_set_tile(x+i, y, ZERO_TILE + d);
   }
 }
 
 
 void show_coins(int x, int y, int coins) {
-  int s = coins;
+  uint32_t digits = math_bcd(coins);
   for(int i=0; i<2; i++) {
-    int d = 0;
-    if (i == 1) d = s;
-    else {
-      int div = divisor[i+3];
-      while (s >= div) {
-        s -= div;
-        d++;
-      } 
-    }
+    int d = (digits >> ((1 - i) << 2)) & 0xf;
     vid_set_tile(x+i, y, ZERO_TILE + d);
   }
 }
@@ -213,11 +200,6 @@ void show_text(int x, int y, uint8_t tile, int len) {
   for(int i=0;i<len;i++) vid_set_tile(x+i, y, tile+i);
 }
 
-// Delay in some units or other
-void delay(uint32_t n) {
-  for (uint32_t i = 0; i < n; i++) asm volatile ("");
-}
-
 void blank_line(int l) {
   for(int i=0;i<64;i++) vid_set_tile(i, l, BLANK_TILE);
 }
@@ -225,7 +207,7 @@ void blank_line(int l) {
 void get_input() {
   // Get Nunchuk data
   i2c_send_reg(0x00);
-  delay(100);
+  delay_us(1600);
 
   jx = i2c_read();
 #ifdef debug
@@ -255,7 +237,8 @@ void get_input() {
 }
 
 void main() {
-  reg_uart_clkdiv = 138;  // 16,000,000 / 115,200
+  reg_uart_clkdiv = UART_CLKDIV(115200);
+  log_init();
   set_irq_mask(0x00);
 
   setup_screen();
@@ -275,7 +258,8 @@ void main() {
   offset = 0;
   bool forwards = true;
 
-  uint32_t time_waster = 0, tick_counter = 0;
+  uint32_t next_tick = timer_now();
+  uint32_t tick_counter = 0;
   int16_t sprite_x = 16, sprite_y = 208;
   int8_t x_speed = 0, y_speed = 0;
   uint8_t under_tile_1 = 0, under_tile_2 = 0;
@@ -292,8 +276,8 @@ void main() {
   }
 
   while (1) {
-    time_waster++;
-    if ((time_waster & 0x7ff) == 0x7ff) {
+    if ((int32_t)(timer_now() - next_tick) >= 0) {
+      next_tick += TICK_US;
       tick_counter++;
   
       // Set up the top two lines 
@@ -351,19 +335,13 @@ void main() {
 // Check for solid object below
         if (y_speed < 0) {
           for(int y = ((sprite_y + y_speed) >> 3);y < ((sprite_y + 8) >> 3); y++) { 
-            print("down y is ");
-            print_hex(y, 4);
-            print(" , sprite_y is ");
-            print_hex(sprite_y, 4);
-            print(" , y_speed is ");
-            print_hex(y_speed, 4);
-            print("\n");
+            LOG_DEBUG(log_str("down y is "); log_dec(y);
+                      log_str(", sprite_y is "); log_dec(sprite_y);
+                      log_str(", y_speed is "); log_dec(y_speed); log_char('\n'));
             for(int x = (sprite_x >> 3); x < ((sprite_x + 24) >> 3); x++) {
               uint8_t t = tile_data[((y+2) << 6) + x];
               if (is_solid(t)) {
-                print("Tile is ");
-                print_hex(t, 4);
-                print("\n");
+                LOG_DEBUG(log_str("Tile is "); log_hex(t, 2); log_char('\n'));
                 sprite_y = y << 3;
                 y_speed = 0;
                 jumping = false;
@@ -377,19 +355,13 @@ void main() {
           }
         } else if (y_speed > 0) { // Check for object above
           for(int y = (sprite_y + y_speed)  >> 3;y > sprite_y >> 3; y--) { 
-            print("up y is ");
-            print_hex(y, 4);
-            print(" , sprite_y is ");
-            print_hex(sprite_y, 4);
-            print(" , y_speed is ");
-            print_hex(y_speed, 4);
-            print("\n");
+            LOG_DEBUG(log_str("up y is "); log_dec(y);
+                      log_str(", sprite_y is "); log_dec(sprite_y);
+                      log_str(", y_speed is "); log_dec(y_speed); log_char('\n'));
             for(int x = ((sprite_x + 16)  >> 3); x < ((sprite_x + 24 + x_speed) >> 3); x++) {
               uint8_t t = tile_data[(y << 6) + x];
               if (is_solid(t)) {
-                print("Tile is ");
-                print_hex(t, 4);
-                print("\n");
+                LOG_DEBUG(log_str("Tile is "); log_hex(t, 2); log_char('\n'));
                 sprite_y = (y << 3) + 8;
                 y_speed = 0;
                 jumping = false;
@@ -402,9 +374,9 @@ void main() {
                   vid_enable_sprite(4, 1);
                   for(int i=0;i<5;i++) {
                     vid_set_tile(x, y-4, COINS_TILE);
-                    delay(5000);
+                    delay_ms(80);
                     vid_set_tile(x, y-4, COINS2_TILE);
-                    delay(5000);
+                    delay_ms(80);
                   }
                   vid_set_tile(x, y-4, BLANK_TILE);
                   vid_enable_sprite(4, 0);
@@ -417,18 +389,12 @@ void main() {
 
         if (x_speed > 0) { // Check for object to right
           for(int x = (sprite_x + 16)   >> 3;x < (sprite_x + 24 + x_speed) >> 3; x++) {
-            print("right x is ");
-            print_hex(x, 4);
-            print(" , sprite_x is ");
-            print_hex(sprite_x, 4);
-            print(" , x_speed is ");
-            print_hex(x_speed, 4);
-            print("\n");
+            LOG_DEBUG(log_str("right x is "); log_dec(x);
+                      log_str(", sprite_x is "); log_dec(sprite_x);
+                      log_str(", x_speed is "); log_dec(x_speed); log_char('\n'));
             for(int y = (sprite_y >> 3); y < ((sprite_y + 16) >> 3); y++) {
               uint8_t t = tile_data[(y << 6) + x];
-              print("Tile is ");
-              print_hex(t, 4);
-              print("\n");
+              LOG_DEBUG(log_str("Tile is "); log_hex(t, 2); log_char('\n'));
               if (is_solid(t)) {
                 x_speed = 0;
                 sprite_x = (x << 3) - 16;
@@ -437,18 +403,12 @@ void main() {
           } 
         } else if (x_speed < 0) { // Check for object to left
             for(int x = (sprite_x + x_speed)  >> 3;x >= sprite_x >> 3; x--) {
-            print("left x is ");
-            print_hex(x, 4);
-            print(" , sprite_x is ");
-            print_hex(sprite_x, 4);
-            print(" , x_speed is ");
-            print_hex(x_speed, 4);
-            print("\n");
+            LOG_DEBUG(log_str("left x is "); log_dec(x);
+                      log_str(", sprite_x is "); log_dec(sprite_x);
+                      log_str(", x_speed is "); log_dec(x_speed); log_char('\n'));
             for(int y = (sprite_y >> 3); y < ((sprite_y + 16) >> 3); y++) {
               uint8_t t = tile_data[(y << 6) + x];
-              print("Tile is ");
-              print_hex(t, 4);
-              print("\n");
+              LOG_DEBUG(log_str("Tile is "); log_hex(t, 2); log_char('\n'));
               if (is_solid(t)) {
                 x_speed = 0;
                 sprite_x = (x << 3) + 8;
@@ -5,7 +5,10 @@
 #include <video/video.h>
 #include <songplayer/songplayer.h>
 #include <uart/uart.h>
+#include <math/math.h>
 #include <button/button.h>
+#include <delay/delay.h>
+#include <timer/timer.h>
 
 #include "graphics_data.h"
 
@@ -19,6 +22,7 @@ extern uint32_t sram;
 #define MAX_SPEED 16 
 #define GRAVITY 4
 #define JUMP_SPEED 24
+#define TICK_US 5000   // movement, scrolling and the clock advance each tick
 #define DEBOUNCE_TICKS 10
 
 #define BLANK_TILE 0
@@ -59,7 +63,7 @@ extern uint32_t sram;
 
 const struct song_t song_pacman;
 
-uint32_t counter_frequency = 16000000/50;  /* 50 times per second */
+uint32_t counter_frequency = SYS_CLK_HZ/50;  /* 50 times per second */
 
 uint16_t score, coins, offset;
 uint32_t game_start, time_left;
@@ -170,38 +174,20 @@ void irq_handler(uint32_t irqs, uint32_t* regs)
   }
 }
 
-const int divisor[] = {10000,1000,100,10};
-
 // Display score, hi-score or another numnber
 void show_score(int x, int y, int score) {
-  int s = score;
+  uint32_t digits = math_bcd(score);
   for(int i=0; i<5; i++) {
-    int d = 0;
-    if (i == 4) d = s;
-    else {
-      int div = divisor[i];
-      while (s >= div) {
-        s -= div;
-        d++;
-      } 
-    }
+    int d = (digits >> ((4 - i) << 2)) & 0xf;
     vid_set_tile(x+i, y, ZERO_TILE + d);
   }
 }
 
 
 void show_coins(int x, int y, int coins) {
-  int s = coins;
+  uint32_t digits = math_bcd(coins);
   for(int i=0; i<2; i++) {
-    int d = 0;
-    if (i == 1) d = s;
-    else {
-      int div = divisor[i+3];
-      while (s >= div) {
-        s -= div;
-        d++;
-      } 
-    }
+    int d = (digits >> ((1 - i) << 2)) & 0xf;
     vid_set_tile(x+i, y, ZERO_TILE + d);
   }
 }
@@ -210,11 +196,6 @@ void show_text(int x, int y, uint8_t tile, int len) {
   for(int i=0;i<len;i++) vid_set_tile(x+i, y, tile+i);
 }
 
-// Delay in some units or other
-void delay(uint32_t n) {
-  for (uint32_t i = 0; i < n; i++) asm volatile ("");
-}
-
 void blank_line(int l) {
   for(int i=0;i<64;i++) vid_set_tile(i, l, BLANK_TILE);
 }
@@ -224,7 +205,7 @@ void get_input() {
 }
 
 void main() {
-  reg_uart_clkdiv = 138;  // 16,000,000 / 115,200
+  reg_uart_clkdiv = UART_CLKDIV(115200);
   set_irq_mask(0x00);
 
   setup_screen();
@@ -241,7 +222,8 @@ void main() {
   offset = 0;
   bool forwards = true;
 
-  uint32_t time_waster = 0, tick_counter = 0;
+  uint32_t next_tick = timer_now();
+  uint32_t tick_counter = 0;
   int16_t sprite_x = 16, sprite_y = 208;
   int8_t x_speed = 0, y_speed = 0;
   uint8_t under_tile_1 = 0, under_tile_2 = 0;
@@ -258,8 +240,8 @@ void main() {
   }
 
   while (1) {
-    time_waster++;
-    if ((time_waster & 0x7ff) == 0x7ff) {
+    if ((int32_t)(timer_now() - next_tick) >= 0) {
+      next_tick += TICK_US;
       tick_counter++;
   
       // Set up the top two lines 
@@ -368,9 +350,9 @@ void main() {
                   vid_enable_sprite(4, 1);
                   for(int i=0;i<5;i++) {
                     vid_set_tile(x, y-4, COINS_TILE);
-                    delay(5000);
+                    delay_ms(80);
                     vid_set_tile(x, y-4, COINS2_TILE);
-                    delay(5000);
+                    delay_ms(80);
                   }
                   vid_set_tile(x, y-4, BLANK_TILE);
                   vid_enable_sprite(4, 0);
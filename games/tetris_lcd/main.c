@@ -5,7 +5,10 @@
 #include <video/video.h>
 #include <songplayer/songplayer.h>
 #include <uart/uart.h>
+#include <math/math.h>
+#include <pcpi/pcpi.h>
 #include <button/button.h>
+#include <timer/timer.h>
 
 #include "graphics_data.h"
 
@@ -16,6 +19,9 @@ extern uint32_t sram;
 #define reg_spictrl (*(volatile uint32_t*)0x02000000)
 #define reg_uart_clkdiv (*(volatile uint32_t*)0x02000004)
 
+// game tick length; a piece drops a row every speed + 1 ticks
+#define TICK_US 5000
+
 #define BLANK_TILE 0
 #define ZERO_TILE 40
 #define ONE_TILE 41
@@ -40,7 +46,7 @@ extern uint32_t sram;
 
 const struct song_t song_pacman;
 
-uint32_t counter_frequency = 16000000/50;  /* 50 times per second */
+uint32_t counter_frequency = SYS_CLK_HZ/50;  /* 50 times per second */
 
 // Working data
 uint16_t score, level, lines;
@@ -125,7 +131,7 @@ void show_board() {
   for(int y=0; y<BOARD_HEIGHT; y++) 
     for(int x=0; x<BOARD_WIDTH; x++) {
       uint8_t p = board[y][x];
-      vid_set_tile(x + 1, y + 9, (p == 0 ? 0 : colors[p-1]));
+      *pcpi_tile_addr(x + 1, y + 9) = (p == 0 ? 0 : colors[p-1]);
     }
 }
 
@@ -168,15 +174,15 @@ uint8_t piece_height(int p, int o) {
   } 
 }
 
+// Bit 15 of a rotation is the top left square, bit 0 the bottom right:
+// visit only the set ones, n = 0 (top left) ... 15
+#define for_each_square(n, bits) \
+  for (uint32_t b = (bits), n; b && (n = 16 - pcpi_ffs(b), 1); b &= b - 1)
+
 // Helper for show piece and blank piece
 void show_piece_c(int x0, int y0, uint8_t p, uint8_t o, uint8_t c) {
-  uint16_t bit = rotations[p][o];
-  
-  for(int y=0;y<4;y++) 
-   for(int x=0;x<4;x++) {
-     if (bit & 0x8000) vid_set_tile(x0+x, y0+y, c);
-     bit <<= 1;
-   }
+  for_each_square(n, rotations[p][o])
+    *pcpi_tile_addr(x0 + (n & 3), y0 + (n >> 2)) = c;
 }
 
 // Show the piece on the board
@@ -191,33 +197,20 @@ void blank_piece(int x, int y, uint8_t p, int o) {
 
 // Place the piece on the board
 void place_piece(int x0, int y0, uint8_t p, uint8_t o) {
-  uint16_t bit = rotations[p][o];
-  
-  for(int y=0;y<4;y++) 
-   for(int x=0;x<4;x++) {
-     if ((bit & 0x8000) &&
-         y0 + y < BOARD_HEIGHT &&
-         x0 + x >= 0 &&
-         x0 + x < BOARD_WIDTH)
-       board[y0 + y][x0 + x] = p + 1;
-     bit <<= 1;
-   }
+  for_each_square(n, rotations[p][o]) {
+    int x = x0 + (n & 3), y = y0 + (n >> 2);
+    if (y < BOARD_HEIGHT && x >= 0 && x < BOARD_WIDTH)
+      board[y][x] = p + 1;
+  }
 }
 
 // Check if current piece touches one on the board
 bool touched() {
-  uint16_t bit = rotations[piece][orientation];
-
-  for(int y=0;y<4;y++) 
-    for(int x=0;x<4;x++) {
-      if ((bit & 0x8000) && 
-           piece_y - 8 + y < BOARD_HEIGHT &&
-           piece_x - 1 + x < BOARD_WIDTH &&
-           piece_x -1 + x >= 0 &&
-           (board[piece_y - 8 + y][piece_x - 1 + x] > 0)) 
-        return true;
-      bit <<= 1;
-    }
+  for_each_square(n, rotations[piece][orientation]) {
+    int x = piece_x - 1 + (n & 3), y = piece_y - 8 + (n >> 2);
+    if (y < BOARD_HEIGHT && x < BOARD_WIDTH && x >= 0 && board[y][x] > 0)
+      return true;
+  }
   return false;
 }
 
@@ -233,21 +226,11 @@ void irq_handler(uint32_t irqs, uint32_t* regs)
   }
 }
 
-const int divisor[] = {10000,1000,100,10};
-
 // Display score, hi-score or another numnber
 void show_score(int x, int y, int score) {
-  int s = score;
+  uint32_t digits = math_bcd(score);
   for(int i=0; i<5; i++) {
-    int d = 0;
-    if (i == 4) d = s;
-    else {
-      int div = divisor[i];
-      while (s >= div) {
-        s -= div;
-        d++;
-      } 
-    }
+    int d = (digits >> ((4 - i) << 2)) & 0xf;
     vid_set_tile(x+i, y, ZERO_TILE + d);
   }
 }
@@ -275,11 +258,6 @@ void check_board() {
   }
 }
 
-// Delay in some units or other
-void delay(uint32_t n) {
-  for (uint32_t i = 0; i < n; i++) asm volatile ("");
-}
-
 void get_input() {
   buttons = reg_buttons;
 }
@@ -304,7 +282,7 @@ void start_game() {
 }
 
 void main() {
-  reg_uart_clkdiv = 138;  // 16,000,000 / 115,200
+  reg_uart_clkdiv = UART_CLKDIV(115200);
   set_irq_mask(0x00);
 
   setup_screen();
@@ -319,16 +297,16 @@ void main() {
   // (the music routine runs from the timer interrupt)
   set_timer_counter(counter_frequency);
 
-  uint32_t time_waster = 0, tick_counter = 0;
+  uint32_t next_tick = timer_now();
+  uint32_t tick_counter = 0;
 
   start_game();
 
   uint8_t rand;
 
   while (1) {
-    time_waster++;
-    
-    if ((time_waster & 0x7ff) == 0x7ff) {
+    if ((int32_t)(timer_now() - next_tick) >= 0) {
+      next_tick += TICK_US;
       tick_counter++;
 
       // Blank the old piece
@@ -1,15 +1,22 @@
 //
-// a very cut-down audio peripheral - wave generators + volume control
+// a very cut-down audio peripheral - wave generators + volume control, and a
+// global state-variable filter that voices can be routed through
 //
 
-module audio
-(
+module audio #(
+  parameter integer SYS_CLK_HZ = 16000000
+) (
   input resetn,
   input clk,
 	input iomem_valid,
 	input [3:0]  iomem_wstrb,
 	input [31:0] iomem_addr,
 	input [31:0] iomem_wdata,
+`ifdef audio_capture
+  output reg iomem_ready,
+  output [31:0] iomem_rdata,
+  output capture_full,  // the capture buffer has wrapped (for the interrupt controller)
+`endif
   output audio_out);
 
   ////////////////////////////////////////////////////////////////////
@@ -24,29 +31,53 @@ module audio
 	reg [31:0] config_register_bank [0:15];
   wire [3:0] bank_addr = iomem_addr[5:2];
 
+  // 0x0400_0040: filter register (see README.md)
+  wire filter_addr = iomem_addr[6];
+  // 0x0400_0080: capture control/status, 0x0400_1000: capture buffer
+  wire capture_addr = iomem_addr[7] || iomem_addr[12];
+  reg [6:0] filter_cutoff;
+  reg [3:0] filter_resonance;
+  reg [3:0] filter_route;      // one bit per voice
+  reg [2:0] filter_mode;       // HP, BP, LP outputs summed
+
   ///////////////////////////////////////////////////////////////////
   //    Handle PicoSoC writing to the config register bank
   ///////////////////////////////////////////////////////////////////
 	always @(posedge clk) begin
-    if (iomem_valid) begin
+    if (iomem_valid && capture_addr) begin
+      // handled by the capture tap
+    end else if (iomem_valid && filter_addr) begin
+      if (iomem_wstrb[0]) filter_cutoff <= iomem_wdata[6:0];
+      if (iomem_wstrb[1]) filter_resonance <= iomem_wdata[11:8];
+      if (iomem_wstrb[2]) filter_route <= iomem_wdata[19:16];
+      if (iomem_wstrb[3]) filter_mode <= iomem_wdata[26:24];
+    end else if (iomem_valid) begin
       if (iomem_wstrb[0]) config_register_bank[bank_addr][ 7: 0] <= iomem_wdata[ 7: 0];
       if (iomem_wstrb[1]) config_register_bank[bank_addr][15: 8] <= iomem_wdata[15: 8];
       if (iomem_wstrb[2]) config_register_bank[bank_addr][23:16] <= iomem_wdata[23:16];
       if (iomem_wstrb[3]) config_register_bank[bank_addr][31:24] <= iomem_wdata[31:24];
     end
+
+    if (!resetn) begin
+      filter_cutoff <= 0;
+      filter_resonance <= 0;
+      filter_route <= 0;
+      filter_mode <= 0;
+    end
 	end
 
   /////////////////////////////////////////////////////////////////////
   // Clocks :: Sample clock @ 44100Hz and accumulator clock @ 1MHz
   /////////////////////////////////////////////////////////////////////
   wire aclk;
-  clock_divider #(.DIVISOR(16)) accumulator_clock(.cin(clk), .cout(aclk));
+  clock_divider #(.DIVISOR(SYS_CLK_HZ / 1000000)) accumulator_clock(.cin(clk), .cout(aclk));
 
 
   /////////////////////////////////////////////////////////////////////
   // AUDIO Output
   /////////////////////////////////////////////////////////////////////
   reg signed [SAMPLE_BITS+1:0] tmp_mixed_voices;
+  reg signed [SAMPLE_BITS+1:0] tmp_filter_input;
   reg signed [SAMPLE_BITS+1:0] mixed_voices;
 
   // and final_mix samples are pulse-density modulated for output
@@ -60,7 +91,7 @@ module audio
   reg[ACCUMULATOR_BITS-1:0] prev_accumulator[0:NUM_VOICES-1];
   reg [22:0] lfsr[0:NUM_VOICES-1];
 
-  reg[5:0] voice_pipeline_state;
+  reg[7:0] voice_pipeline_state;
   reg [1:0] voice_num;
   wire[3:0] reg_index = voice_num<<2; // offset into config register file for current voice (4 words per voice)
 
@@ -122,13 +153,143 @@ module audio
 
   wire signed [SAMPLE_BITS+9-1:0] scaled_voice_output = (unscaled_voice_output * voice_volume) >>> 8;
 
+  ///////////////////////////////////////////////////////////////////
+  // State-variable (Chamberlin) filter, run once per 1MHz sample:
+  //
+  //   lp = lp + f*bp
+  //   hp = in - lp - q*bp
+  //   bp = bp + f*hp
+  //
+  // f and q are applied with shifts and adds rather than a multiplier:
+  //
+  //   f = (8 + cutoff[2:0]) * 2^(cutoff[6:3] - 16)    (~20Hz .. ~18kHz)
+  //   q = (16 - resonance) / 8                         (2 .. 1/8)
+  //
+  // Both f*x steps share one shifter; the pipeline feeds it bp in state 4
+  // and (registered) hp in state 6.  The mixer output is latched in state 4,
+  // as before, so it carries the filter outputs of the previous sample.
+  ///////////////////////////////////////////////////////////////////
+  localparam FILTER_FRACTION_BITS = 10;
+  localparam FILTER_BITS = SAMPLE_BITS + 2 + FILTER_FRACTION_BITS + 3;  // 3 bits headroom for resonance
+  localparam FILTER_WIDE_BITS = FILTER_BITS + 5;
+
+  reg signed [FILTER_BITS-1:0] filter_lp;
+  reg signed [FILTER_BITS-1:0] filter_bp;
+  reg signed [FILTER_BITS-1:0] filter_hp;
+
+  function [FILTER_BITS-1:0] filter_saturate(input [FILTER_WIDE_BITS-1:0] v);
+    filter_saturate = (v[FILTER_WIDE_BITS-1:FILTER_BITS-1] == {(FILTER_WIDE_BITS-FILTER_BITS+1){v[FILTER_WIDE_BITS-1]}})
+                    ? v[FILTER_BITS-1:0] : {v[FILTER_WIDE_BITS-1], {(FILTER_BITS-1){~v[FILTER_WIDE_BITS-1]}}};
+  endfunction
+
+  wire signed [FILTER_WIDE_BITS-1:0] filter_in = {{(FILTER_WIDE_BITS-SAMPLE_BITS-2-FILTER_FRACTION_BITS){tmp_filter_input[SAMPLE_BITS+1]}},
+                                                   tmp_filter_input, {FILTER_FRACTION_BITS{1'b0}}};
+  wire signed [FILTER_WIDE_BITS-1:0] filter_lp_wide = filter_lp;
+  wire signed [FILTER_WIDE_BITS-1:0] filter_bp_wide = filter_bp;
+
+  wire [4:0] filter_damping = 5'd16 - filter_resonance;
+  wire signed [FILTER_WIDE_BITS-1:0] filter_damped_bp_x8 = (filter_damping[4] ? filter_bp_wide <<< 4 : 0)
+                                                          + (filter_damping[3] ? filter_bp_wide <<< 3 : 0)
+                                                          + (filter_damping[2] ? filter_bp_wide <<< 2 : 0)
+                                                          + (filter_damping[1] ? filter_bp_wide <<< 1 : 0)
+                                                          + (filter_damping[0] ? filter_bp_wide : 0);
+  wire signed [FILTER_BITS-1:0] filter_hp_next = filter_saturate(filter_in - filter_lp_wide - (filter_damped_bp_x8 >>> 3));
+  wire signed [FILTER_WIDE_BITS-1:0] filter_hp_wide = filter_hp;
+
+  wire [3:0] filter_octave = (filter_cutoff[6:3] > 4'd9) ? 4'd9 : filter_cutoff[6:3];
+  wire signed [FILTER_WIDE_BITS-1:0] filter_operand = voice_pipeline_state[4] ? filter_bp_wide : filter_hp_wide;
+  wire signed [FILTER_WIDE_BITS-1:0] filter_operand_scaled = (filter_operand <<< 3)
+                                                            + (filter_cutoff[2] ? filter_operand <<< 2 : 0)
+                                                            + (filter_cutoff[1] ? filter_operand <<< 1 : 0)
+                                                            + (filter_cutoff[0] ? filter_operand : 0);
+  wire signed [FILTER_WIDE_BITS-1:0] filter_step = filter_operand_scaled >>> (5'd16 - filter_octave);
+
+  // selected filter outputs, added to the unfiltered voices (saturating)
+  wire signed [FILTER_WIDE_BITS-1:0] filter_out = (filter_mode[0] ? filter_lp_wide : 0)
+                                                + (filter_mode[1] ? filter_bp_wide : 0)
+                                                + (filter_mode[2] ? filter_hp_wide : 0);
+  wire signed [FILTER_WIDE_BITS-1:0] final_mix = (filter_out >>> FILTER_FRACTION_BITS) + tmp_mixed_voices;
+  wire final_mix_clipped = final_mix[FILTER_WIDE_BITS-1:SAMPLE_BITS+1] != {(FILTER_WIDE_BITS-SAMPLE_BITS-1){final_mix[FILTER_WIDE_BITS-1]}};
+
+  ///////////////////////////////////////////////////////////////////
+  // Capture tap: records every (decimation+1)th mixer sample into a
+  // block RAM ring buffer which the CPU can read back, so the actual
+  // output can be checked without listening to the PDM pin.
+  ///////////////////////////////////////////////////////////////////
+`ifdef audio_capture
+  localparam CAPTURE_ADDR_BITS = 9;   // 512 samples, 2 BRAMs
+
+  reg [15:0] capture_buffer [0:(1<<CAPTURE_ADDR_BITS)-1];
+  reg [15:0] capture_read_data;
+  reg [CAPTURE_ADDR_BITS-1:0] capture_index;
+  reg [15:0] capture_decimation;
+  reg [15:0] capture_decimation_count;
+  reg capture_running;
+  reg capture_wrapped;
+  reg capture_one_shot;
+  reg capture_wait_for_write;
+
+  wire capture_ctrl_write = iomem_valid && !iomem_ready && iomem_addr[7] && (iomem_wstrb != 0);
+  wire voice_register_write = iomem_valid && !capture_addr && !filter_addr && (iomem_wstrb != 0);
+
+  assign capture_full = capture_wrapped;
+
+  assign iomem_rdata = iomem_addr[12] ? {{16{capture_read_data[15]}}, capture_read_data}
+                                      : {{(16-CAPTURE_ADDR_BITS){1'b0}}, capture_index,
+                                         13'b0, capture_wait_for_write, capture_wrapped, capture_running};
+
+  always @(posedge clk) begin
+    // registers (and the buffer) are read one clock after iomem_valid, like gpio
+    iomem_ready <= iomem_valid && !iomem_ready;
+    capture_read_data <= capture_buffer[iomem_addr[CAPTURE_ADDR_BITS+1:2]];
+
+    if (capture_ctrl_write) begin
+      capture_running <= iomem_wdata[0] && !iomem_wdata[2];
+      capture_one_shot <= iomem_wdata[1];
+      capture_wait_for_write <= iomem_wdata[0] && iomem_wdata[2];
+      capture_decimation <= iomem_wdata[31:16];
+      capture_decimation_count <= 0;
+      capture_index <= 0;
+      capture_wrapped <= 0;
+    end else begin
+      if (capture_wait_for_write && voice_register_write) begin
+        capture_wait_for_write <= 0;
+        capture_running <= 1;
+      end
+
+      // mixed_voices was latched in state 4
+      if (capture_running && voice_pipeline_state[5]) begin
+        if (capture_decimation_count == 0) begin
+          capture_buffer[capture_index] <= {{(16-SAMPLE_BITS-2){mixed_voices[SAMPLE_BITS+1]}}, mixed_voices};
+          capture_index <= capture_index + 1;
+          if (&capture_index) begin
+            capture_wrapped <= 1;
+            if (capture_one_shot) capture_running <= 0;
+          end
+          capture_decimation_count <= capture_decimation;
+        end else begin
+          capture_decimation_count <= capture_decimation_count - 1;
+        end
+      end
+    end
+
+    if (!resetn) begin
+      iomem_ready <= 0;
+      capture_running <= 0;
+      capture_wait_for_write <= 0;
+      capture_wrapped <= 0;
+      capture_index <= 0;
+    end
+  end
+`endif
+
   ///////////////////////////////////////////////////////////////////
   // handle voice logic
   ///////////////////////////////////////////////////////////////////
   always @(posedge clk) begin
     prev_aclk <= aclk;
 
-    voice_pipeline_state <= 6'b100000;
+    voice_pipeline_state <= 8'b10000000;
 
     /////////////////////////////////////////////////////////////////
     // state machine iterates through each voice, one-at-a-time,
@@ -157,7 +318,10 @@ module audio
         ringmod_bit[1<<voice_num] <= voice_accumulator[ACCUMULATOR_BITS-1];
 
         // scale samples by envelope generator, and add them either to the filter chain, or non-filter chain
-        tmp_mixed_voices <= tmp_mixed_voices + scaled_voice_output[SAMPLE_BITS+1:0];
+        if (filter_route[voice_num])
+          tmp_filter_input <= tmp_filter_input + scaled_voice_output[SAMPLE_BITS+1:0];
+        else
+          tmp_mixed_voices <= tmp_mixed_voices + scaled_voice_output[SAMPLE_BITS+1:0];
 
         // move on to the next voice
         voice_num <= voice_num + 1;
@@ -165,14 +329,29 @@ module audio
       end
       voice_pipeline_state[4]: begin
         // latch sample value out
-        mixed_voices <= tmp_mixed_voices;
-        voice_pipeline_state <= 6'b100000;  // move to "idle" state until next aclk
+        mixed_voices <= final_mix_clipped ? {final_mix[FILTER_WIDE_BITS-1], {(SAMPLE_BITS+1){~final_mix[FILTER_WIDE_BITS-1]}}}
+                                          : final_mix[SAMPLE_BITS+1:0];
+
+        // filter: lp += f*bp
+        filter_lp <= filter_saturate(filter_lp_wide + filter_step);
+        voice_pipeline_state <= voice_pipeline_state << 1;
       end
       voice_pipeline_state[5]: begin
+        // filter: hp = in - lp - q*bp
+        filter_hp <= filter_hp_next;
+        voice_pipeline_state <= voice_pipeline_state << 1;
+      end
+      voice_pipeline_state[6]: begin
+        // filter: bp += f*hp
+        filter_bp <= filter_saturate(filter_bp_wide + filter_step);
+        voice_pipeline_state <= 8'b10000000;  // move to "idle" state until next aclk
+      end
+      voice_pipeline_state[7]: begin
         // accumulator clock has gone high; reset state machine
         if (!prev_aclk && aclk) begin
-          voice_pipeline_state <= 6'b000001;
+          voice_pipeline_state <= 8'b00000001;
           tmp_mixed_voices <= 0;
+          tmp_filter_input <= 0;
           voice_num <= 0;
         end
       end
@@ -180,7 +359,10 @@ module audio
 
     if (!resetn) begin
       voice_num <= 0;
-      voice_pipeline_state <= 6'b100000;
+      voice_pipeline_state <= 8'b10000000;
+      filter_lp <= 0;
+      filter_bp <= 0;
+      filter_hp <= 0;
       lfsr[0] <= 23'b01101110010010000101011;
       lfsr[1] <= 23'b01101110010010000101011;
       lfsr[2] <= 23'b01101110010010000101011;
@@ -0,0 +1,143 @@
+/*
+ * DMA engine for PicoSOC: copies words from one address to another on
+ * picosoc's memory bus, which it shares with the CPU (picosoc ENABLE_DMA),
+ * so it can read the SPI flash, RAM or a peripheral and write RAM or any
+ * peripheral.  Each side's address either goes up a word at a time or
+ * stays put, for a peripheral's data register.  Channels with work take
+ * turns a word at a time, and the CPU can take the bus between every read
+ * and write.  A channel that finishes sets its done bit and pulses done
+ * (for the interrupt controller).
+ *
+ * See README.md for the registers.
+ */
+module dma
+(
+  input resetn,
+  input clk,
+	input iomem_valid,
+	input [3:0]  iomem_wstrb,
+	input [31:0] iomem_addr,
+  output reg [31:0] iomem_rdata,
+  output reg iomem_ready,
+	input [31:0] iomem_wdata,
+
+  // bus master, into picosoc's dma_* port
+  output reg        mem_valid,
+  input             mem_ready,
+  output reg [3:0]  mem_wstrb,
+  output reg [31:0] mem_addr,
+  output reg [31:0] mem_wdata,
+  input      [31:0] mem_rdata,
+
+  output reg done);
+
+  localparam CHANNELS = 2;
+
+  reg [CHANNELS-1:0] busy;
+  reg [CHANNELS-1:0] finished;
+  reg [CHANNELS-1:0] src_inc;
+  reg [CHANNELS-1:0] dst_inc;
+  reg [31:0] src [0:CHANNELS-1];
+  reg [31:0] dst [0:CHANNELS-1];
+  reg [15:0] count [0:CHANNELS-1];   // words left
+
+  reg ch;          // the channel being served
+  reg writing;     // its word has been read, and is in mem_wdata
+
+  // the next channel with work, taking turns from the one after ch
+  reg next_ch;
+  reg next_any;
+  integer n;
+  always @* begin
+    next_ch = ch;
+    next_any = 0;
+    for (n = CHANNELS; n > 0; n = n - 1) begin
+      if (busy[(ch + n) % CHANNELS]) begin
+        next_ch = (ch + n) % CHANNELS;
+        next_any = 1;
+      end
+    end
+  end
+
+  // busy as seen by the CPU: until the last word has been written, even
+  // after the channel was stopped, so it is safe to set up again
+  wire [CHANNELS-1:0] in_flight = mem_valid ? 1 << ch : 0;
+  wire [CHANNELS-1:0] busy_status = busy | in_flight;
+
+  wire word_done = mem_valid && mem_ready && writing;
+  wire [CHANNELS-1:0] finish = word_done && count[ch] == 1 ? 1 << ch : 0;
+
+  wire reg_write = iomem_valid && !iomem_ready && iomem_wstrb[0];
+  wire [1:0] channel = iomem_addr[5:4] - 2'd1;     // 0x10 + 0x10 * channel
+  wire channel_addr = iomem_addr[5:4] != 2'd0 && channel < CHANNELS;
+
+	always @(posedge clk) begin
+		if (!resetn) begin
+      busy <= 0;
+      finished <= 0;
+      ch <= 0;
+      writing <= 0;
+      mem_valid <= 0;
+      done <= 0;
+      iomem_ready <= 0;
+		end else begin
+      if (mem_valid) begin
+        if (mem_ready) begin
+          if (!writing) begin
+            // straight on to the write; the CPU can take the bus in between
+            mem_wdata <= mem_rdata;
+            mem_wstrb <= 4'b1111;
+            mem_addr <= dst[ch];
+            writing <= 1;
+          end else begin
+            mem_valid <= 0;
+            writing <= 0;
+            if (src_inc[ch]) src[ch] <= src[ch] + 4;
+            if (dst_inc[ch]) dst[ch] <= dst[ch] + 4;
+            count[ch] <= count[ch] - 1;
+          end
+        end
+      end else if (next_any) begin
+        ch <= next_ch;
+        mem_valid <= 1;
+        mem_wstrb <= 4'b0000;
+        mem_addr <= src[next_ch];
+      end
+
+      busy <= busy & ~finish;
+      done <= |finish;
+      // finishing wins over a write to the same done bit
+      finished <= (reg_write && !channel_addr && iomem_addr[3:2] == 2'd1 ?
+                   finished & ~iomem_wdata[CHANNELS-1:0] : finished) | finish;
+
+      // register writes come last, so they win over the engine's updates
+      iomem_ready <= 0;
+			if (iomem_valid && !iomem_ready) begin
+        iomem_ready <= 1;
+        if (iomem_wstrb[0] && channel_addr) begin
+          case (iomem_addr[3:2])
+            2'd0: src[channel] <= iomem_wdata;
+            2'd1: dst[channel] <= iomem_wdata;
+            2'd2: count[channel] <= iomem_wdata[15:0];
+            2'd3: begin
+              busy[channel] <= iomem_wdata[0] && count[channel] != 0;
+              src_inc[channel] <= iomem_wdata[1];
+              dst_inc[channel] <= iomem_wdata[2];
+            end
+          endcase
+        end
+        if (channel_addr) case (iomem_addr[3:2])
+          2'd0: iomem_rdata <= src[channel];
+          2'd1: iomem_rdata <= dst[channel];
+          2'd2: iomem_rdata <= count[channel];
+          2'd3: iomem_rdata <= {dst_inc[channel], src_inc[channel], busy_status[channel]};
+        endcase else case (iomem_addr[3:2])
+          2'd0: iomem_rdata <= busy_status;
+          2'd1: iomem_rdata <= finished;
+          default: iomem_rdata <= 0;
+        endcase
+			end
+		end
+	end
+
+endmodule
@@ -14,6 +14,7 @@ module gpio
   output reg iomem_ready,
 	input [31:0] iomem_wdata,
   inout [7:0] BUTTONS, /* buttons in from FPGA pins */
+  output [7:0] buttons, /* button state, 1 = pressed (for the interrupt controller) */
   output led);
 
   wire[7:0] gpio_buttons;
@@ -26,6 +27,8 @@ module gpio
       .D_IN_0(gpio_buttons)
   );
 
+  assign buttons = ~gpio_buttons;
+
 	reg [31:0] gpio;
 	assign led = gpio[0];
 
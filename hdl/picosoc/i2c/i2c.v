@@ -1,5 +1,7 @@
 
-module i2c(
+module i2c #(
+  parameter integer SYS_CLK_HZ = 16000000
+) (
   input resetn,
   input clk,
 	input iomem_valid,
@@ -9,14 +11,17 @@ module i2c(
 	input [31:0] iomem_wdata,
   output reg [31:0] iomem_rdata,
   inout I2C_SDA,
-  inout I2C_SCL
+  inout I2C_SCL,
+  output busy           // a transfer is under way (for the interrupt controller)
 );
 
   reg i2c_enable = 0, i2c_read = 0;
   reg [31:0] i2c_write_reg = 0;
   reg [31:0] i2c_read_reg;
 
-  I2C_master #(.freq(16)) i2c (
+  assign busy = i2c_read_reg[31];
+
+  I2C_master #(.freq(SYS_CLK_HZ / 1000000)) i2c (
       .SDA(I2C_SDA),
       .SCL(I2C_SCL),
       .sys_clock(clk),
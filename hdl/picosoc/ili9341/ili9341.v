@@ -1,6 +1,6 @@
 module ili9341 (
            input            resetn,
-           input            clk_16MHz,
+           input            clk,
            output reg       nreset,
            output reg       cmd_data, // 1 => Data, 0 => Command
            output reg       write_edge, // Write signal on rising edge
@@ -13,10 +13,12 @@ module ili9341 (
            );
 
    parameter  clk_freq = 16000000;
+   // each byte is written in 2 clocks of tx_clk_freq (125ns), a little
+   // over the ILI9341's 66ns write cycle: faster clocks stretch both halves
    parameter  tx_clk_freq = 16000000;
    localparam tx_clk_div = (clk_freq / tx_clk_freq) - 1;
 
-   localparam sec_per_tick = (1.0 / tx_clk_freq);
+   localparam sec_per_tick = (1.0 / clk_freq);
    localparam ms120 = 0.120 / sec_per_tick;
    localparam ms50  = 0.050 / sec_per_tick;
    localparam ms5   = 0.005 / sec_per_tick;
@@ -182,11 +184,13 @@ module ili9341 (
 
    reg [2:0] state = RESET;
 
-   parameter TX_IDLE = 1'd0;
-   parameter TX_DATA_READY = 1'd1;
-   reg       tx_state = TX_IDLE;
+   parameter TX_IDLE = 2'd0;
+   parameter TX_DATA_READY = 2'd1;
+   parameter TX_HOLD = 2'd2;
+   reg [1:0] tx_state = TX_IDLE;
+   reg [1:0] tx_count = 0;
 
-   reg [19:0] delay_ticks = 0;
+   reg [22:0] delay_ticks = 0;
 
    parameter PIX_IDLE = 1'd0;
    parameter PIX_SEND = 1'd1;
@@ -195,7 +199,7 @@ module ili9341 (
 
    assign busy = (state != READY) || (pix_state != PIX_IDLE);
 
-   always @(posedge clk_16MHz) begin
+   always @(posedge clk) begin
 
       if (!resetn) state <= RESET;
       else begin 
@@ -205,8 +209,22 @@ module ili9341 (
                write_edge <= 0;
             end
             TX_DATA_READY : begin
-               write_edge <= 1;
-               tx_state <= TX_IDLE;
+               if (tx_count == tx_clk_div) begin
+                  write_edge <= 1;
+                  tx_count <= 0;
+                  tx_state <= tx_clk_div == 0 ? TX_IDLE : TX_HOLD;
+               end else begin
+                  tx_count <= tx_count + 1;
+               end
+            end
+            TX_HOLD : begin
+               // keep write_edge high as long as it was low
+               if (tx_count == tx_clk_div - 1) begin
+                  tx_count <= 0;
+                  tx_state <= TX_IDLE;
+               end else begin
+                  tx_count <= tx_count + 1;
+               end
             end
          endcase
 
@@ -1,6 +1,7 @@
 
-module ili9341_direct
-(
+module ili9341_direct #(
+  parameter integer SYS_CLK_HZ = 16000000
+) (
   input            resetn,
   input            clk,
   input            iomem_valid,
@@ -18,11 +19,19 @@ module ili9341_direct
   reg [2:0] fast_state;
   reg [15:0] num_bytes;
 
+  // each write_edge level is held for a 16MHz clock (62.5ns) or longer, so
+  // a write cycle stays over the ILI9341's 66ns minimum at any SYS_CLK_HZ
+  localparam integer PHASE_CLOCKS = SYS_CLK_HZ / 16000000;
+  reg [1:0] phase_count;
+  wire phase_done = phase_count == 0;
+
   always @(posedge clk) begin
     iomem_ready <= 0;
+    if (phase_count != 0) phase_count <= phase_count - 1;
     if (!resetn) begin
       state <= 0;
       fast_state <= 0;
+      phase_count <= 0;
       cmd_data <= 0;
       nreset <= 1;
       write_edge <= 0;
@@ -31,7 +40,10 @@ module ili9341_direct
         iomem_ready <= 1;
         if (iomem_addr[7:0] == 'h08) cmd_data <= iomem_wdata;
         else if (iomem_addr[7:0] == 'h0c) nreset <= iomem_wdata;
-        else if (iomem_addr[7:0] == 'h00) begin
+        else if (!phase_done && (iomem_addr[7:0] == 'h00 || iomem_addr[7:0] == 'h04)) begin
+          iomem_ready <= 0;
+        end else if (iomem_addr[7:0] == 'h00) begin
+          phase_count <= PHASE_CLOCKS - 1;
           case (state)
             0 : begin
               write_edge <= 0;
@@ -52,6 +64,7 @@ module ili9341_direct
           endcase
         end else if (iomem_addr[7:0] == 'h04) begin // fast xfer
           iomem_ready <= 0;
+          phase_count <= PHASE_CLOCKS - 1;
           case (fast_state)
             0 : begin
               num_bytes <= iomem_wdata[31:16];
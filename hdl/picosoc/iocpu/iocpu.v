@@ -0,0 +1,133 @@
+/*
+ * A second, minimal picorv32 for audio and IO work, with its own RAM for
+ * program, data and stack, and a RAM shared with the main CPU as a
+ * mailbox.  Its peripheral accesses (0x03xx_xxxx and up) come out on its
+ * own iomem bus, which top.v merges with the main CPU's (iomem_arbiter.v).
+ *
+ * The main CPU sees it as an iomem peripheral (host_*):
+ *   +0x00_0000  private RAM: written by the loader, only while stopped
+ *   +0x10_0000  shared RAM
+ *   +0x20_0000  control: bit 0 run (0 holds the CPU in reset)
+ *
+ * The coprocessor sees its private RAM at 0x0000_0000, where it starts, and
+ * the shared RAM at 0x0100_0000.  See README.md.
+ */
+module iocpu #(
+	parameter integer MEM_WORDS = 1024,
+	parameter integer SHARED_WORDS = 256
+) (
+	input clk,
+	input resetn,
+
+	input             host_valid,
+	input      [3:0]  host_wstrb,
+	input      [31:0] host_addr,
+	input      [31:0] host_wdata,
+	output reg        host_ready,
+	output     [31:0] host_rdata,
+
+	output        iomem_valid,
+	input         iomem_ready,
+	output [ 3:0] iomem_wstrb,
+	output [31:0] iomem_addr,
+	output [31:0] iomem_wdata,
+	input  [31:0] iomem_rdata
+);
+	localparam SRC_CTRL = 2'd0, SRC_RAM = 2'd1, SRC_SHARED = 2'd2;
+
+	reg run;
+
+	wire mem_valid;
+	wire mem_instr;
+	wire mem_ready;
+	wire [31:0] mem_addr;
+	wire [31:0] mem_wdata;
+	wire [3:0] mem_wstrb;
+	wire [31:0] mem_rdata;
+
+	picorv32 #(
+		.STACKADDR(4*MEM_WORDS),
+		.PROGADDR_RESET(32'h 0000_0000),
+		.BARREL_SHIFTER(0),
+		.TWO_STAGE_SHIFT(0),
+		.COMPRESSED_ISA(0),
+		.ENABLE_MUL(0),
+		.ENABLE_DIV(0),
+		.ENABLE_IRQ(0),
+		.ENABLE_COUNTERS(1),         // rdcycle, for timing
+		.ENABLE_COUNTERS64(0),
+		.CATCH_MISALIGN(0),
+		.CATCH_ILLINSN(0)
+	) cpu (
+		.clk         (clk             ),
+		.resetn      (resetn && run   ),
+		.mem_valid   (mem_valid       ),
+		.mem_instr   (mem_instr       ),
+		.mem_ready   (mem_ready       ),
+		.mem_addr    (mem_addr        ),
+		.mem_wdata   (mem_wdata       ),
+		.mem_wstrb   (mem_wstrb       ),
+		.mem_rdata   (mem_rdata       )
+	);
+
+	wire cpu_ram_sel    = mem_valid && !mem_ready && mem_addr < 4*MEM_WORDS;
+	wire cpu_shared_sel = mem_valid && !mem_ready && mem_addr[31:24] == 8'h 01;
+
+	reg ram_ready, shared_ready;
+	wire [31:0] ram_rdata, shared_rdata;
+
+	always @(posedge clk) begin
+		ram_ready <= cpu_ram_sel;
+		shared_ready <= cpu_shared_sel;
+	end
+
+	assign iomem_valid = mem_valid && (mem_addr[31:24] > 8'h 02);
+	assign iomem_wstrb = mem_wstrb;
+	assign iomem_addr = mem_addr;
+	assign iomem_wdata = mem_wdata;
+
+	assign mem_ready = (iomem_valid && iomem_ready) || ram_ready || shared_ready;
+	assign mem_rdata = ram_ready ? ram_rdata : shared_ready ? shared_rdata : iomem_rdata;
+
+	// the host: the private RAM while stopped, the shared RAM whenever the
+	// coprocessor isn't using it, and the control register
+	wire host_sel        = host_valid && !host_ready;
+	wire host_ram_sel    = host_sel && host_addr[21:20] == 2'd0;
+	wire host_shared_sel = host_sel && host_addr[21:20] == 2'd1 && !cpu_shared_sel;
+	wire host_ctrl_sel   = host_sel && host_addr[21:20] == 2'd2;
+
+	reg [1:0] host_src;
+
+	always @(posedge clk) begin
+		host_ready <= 0;
+		if (!resetn) begin
+			run <= 0;
+		end else begin
+			if (host_ram_sel || host_shared_sel || host_ctrl_sel) begin
+				host_ready <= 1;
+				host_src <= host_ram_sel ? SRC_RAM : host_shared_sel ? SRC_SHARED : SRC_CTRL;
+			end
+			if (host_ctrl_sel && host_wstrb[0])
+				run <= host_wdata[0];
+		end
+	end
+
+	assign host_rdata = host_src == SRC_RAM ? (run ? 32'h 0 : ram_rdata) :
+			host_src == SRC_SHARED ? shared_rdata : {31'h 0, run};
+
+	picosoc_mem #(.WORDS(MEM_WORDS)) memory (
+		.clk(clk),
+		.wen(run ? (cpu_ram_sel ? mem_wstrb : 4'b0) : (host_ram_sel ? host_wstrb : 4'b0)),
+		.addr(run ? mem_addr[23:2] : {4'h 0, host_addr[19:2]}),
+		.wdata(run ? mem_wdata : host_wdata),
+		.rdata(ram_rdata)
+	);
+
+	picosoc_mem #(.WORDS(SHARED_WORDS)) shared (
+		.clk(clk),
+		.wen(cpu_shared_sel ? mem_wstrb : host_shared_sel ? host_wstrb : 4'b0),
+		.addr(cpu_shared_sel ? mem_addr[23:2] : {4'h 0, host_addr[19:2]}),
+		.wdata(cpu_shared_sel ? mem_wdata : host_wdata),
+		.rdata(shared_rdata)
+	);
+endmodule
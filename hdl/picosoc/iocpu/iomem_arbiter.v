@@ -0,0 +1,59 @@
+/*
+ * Shares a bus between two masters: top.v puts the main CPU (a) and the IO
+ * coprocessor (b) on the iomem peripheral bus with it, and picosoc the CPU
+ * (a) and the DMA engine (b) on its memory bus.  A master keeps the bus
+ * from its first valid clock until the target is ready; when both wait,
+ * they take turns.  An idle bus goes to whoever asks, with no extra clock.
+ */
+module iomem_arbiter (
+	input clk,
+	input resetn,
+
+	input             a_valid,
+	output            a_ready,
+	input      [ 3:0] a_wstrb,
+	input      [31:0] a_addr,
+	input      [31:0] a_wdata,
+	output     [31:0] a_rdata,
+
+	input             b_valid,
+	output            b_ready,
+	input      [ 3:0] b_wstrb,
+	input      [31:0] b_addr,
+	input      [31:0] b_wdata,
+	output     [31:0] b_rdata,
+
+	output        iomem_valid,
+	input         iomem_ready,
+	output [ 3:0] iomem_wstrb,
+	output [31:0] iomem_addr,
+	output [31:0] iomem_wdata,
+	input  [31:0] iomem_rdata
+);
+	reg locked;     // a transfer is under way
+	reg owner_b;    // who has (or last had) the bus
+
+	wire sel_b = locked ? owner_b : b_valid && (!a_valid || !owner_b);
+
+	assign iomem_valid = sel_b ? b_valid : a_valid;
+	assign iomem_wstrb = sel_b ? b_wstrb : a_wstrb;
+	assign iomem_addr  = sel_b ? b_addr  : a_addr;
+	assign iomem_wdata = sel_b ? b_wdata : a_wdata;
+
+	wire done = iomem_valid && iomem_ready;
+
+	assign a_ready = done && !sel_b;
+	assign b_ready = done && sel_b;
+	assign a_rdata = iomem_rdata;
+	assign b_rdata = iomem_rdata;
+
+	always @(posedge clk) begin
+		if (!resetn) begin
+			locked <= 0;
+			owner_b <= 0;
+		end else begin
+			owner_b <= sel_b;
+			locked <= iomem_valid && !iomem_ready;
+		end
+	end
+endmodule
@@ -0,0 +1,122 @@
+/*
+ * Interrupt controller for PicoSOC: turns SoC events into picorv32's
+ * irq_5 (video), irq_6 (input and the UART) and irq_7 (storage, audio and DMA).  Each
+ * event sets a pending bit, and a line pulses for a clock whenever one of
+ * its enabled events happens, or an event that is still pending is
+ * enabled; software acknowledges a bit to clear it.  picorv32 latches the
+ * pulse, so it is taken once, where a level held until the acknowledge
+ * would be latched again after the handler was entered.
+ *
+ * See README.md for the registers and the event bits.
+ */
+module irqctl
+(
+  input resetn,
+  input clk,
+	input iomem_valid,
+	input [3:0]  iomem_wstrb,
+	input [31:0] iomem_addr,
+  output reg [31:0] iomem_rdata,
+  output reg iomem_ready,
+	input [31:0] iomem_wdata,
+
+  // event sources
+  input       video_vblank,     // high while in vertical blanking
+  input [8:0] video_line,       // line being drawn
+  input [7:0] buttons,          // 1 = pressed
+  input       i2c_busy,
+  input       sdcard_done,      // a one clock pulse per transfer
+  input       uart_rx_valid,    // a received byte is waiting
+  input       uart_tx_empty,    // the UART's TX FIFO is empty
+  input       audio_capture_wrapped,
+  input       timer_match,      // a one clock pulse as timer channels fire
+  input       dma_done,         // a one clock pulse as DMA channels finish
+
+  output irq_5,
+  output irq_6,
+  output irq_7);
+
+  localparam EV_VBLANK = 0, EV_RASTER = 1, EV_BUTTON = 2, EV_I2C = 3,
+             EV_UART_RX = 4, EV_SDCARD = 5, EV_AUDIO = 6, EV_TIMER = 7, EV_DMA = 8,
+             EV_UART_TX = 9;
+  localparam NUM_EVENTS = 10;
+
+  localparam [NUM_EVENTS-1:0] IRQ_5_EVENTS = 10'b0010000011,  // vblank, raster, timer
+                              IRQ_6_EVENTS = 10'b1000011100,  // button, I2C, UART RX and TX
+                              IRQ_7_EVENTS = 10'b0101100000;  // SD card, audio, DMA
+
+  reg [NUM_EVENTS-1:0] pending;
+  reg [NUM_EVENTS-1:0] enable;
+  reg [8:0] raster_line;
+
+  // previous values, for edges
+  reg prev_vblank, prev_i2c_busy, prev_uart_rx_valid, prev_uart_tx_empty, prev_audio_capture_wrapped;
+  reg [8:0] prev_line;
+  reg [7:0] prev_buttons;
+
+  wire [NUM_EVENTS-1:0] events;
+  assign events[EV_VBLANK]  = video_vblank && !prev_vblank;
+  assign events[EV_RASTER]  = !video_vblank && video_line == raster_line && video_line != prev_line;
+  assign events[EV_BUTTON]  = buttons != prev_buttons;
+  assign events[EV_I2C]     = !i2c_busy && prev_i2c_busy;
+  assign events[EV_UART_RX] = uart_rx_valid && !prev_uart_rx_valid;
+  assign events[EV_SDCARD]  = sdcard_done;
+  assign events[EV_AUDIO]   = audio_capture_wrapped && !prev_audio_capture_wrapped;
+  assign events[EV_TIMER]   = timer_match;
+  assign events[EV_DMA]     = dma_done;
+  assign events[EV_UART_TX] = uart_tx_empty && !prev_uart_tx_empty;
+
+  // every enabled event pulses, even onto a bit that is already pending
+  // (say one that arrived with its acknowledge), so none goes unhandled
+  reg  [NUM_EVENTS-1:0] prev_enable;
+  wire [NUM_EVENTS-1:0] new_active = (events & enable) | (pending & enable & ~prev_enable);
+  assign irq_5 = |(new_active & IRQ_5_EVENTS);
+  assign irq_6 = |(new_active & IRQ_6_EVENTS);
+  assign irq_7 = |(new_active & IRQ_7_EVENTS);
+
+  wire reg_write = iomem_valid && !iomem_ready && iomem_wstrb[0];
+  wire ack = reg_write && iomem_addr[4:2] == 3'd2;
+
+  // enable writes: the whole register, or 1s set (0x10) or clear (0x14)
+  // bits, so a handler changing one event can't lose another's change
+  wire enable_write = reg_write && iomem_addr[4:2] == 3'd1;
+  wire enable_set   = reg_write && iomem_addr[4:2] == 3'd4;
+  wire enable_clear = reg_write && iomem_addr[4:2] == 3'd5;
+
+	always @(posedge clk) begin
+    prev_vblank <= video_vblank;
+    prev_line <= video_line;
+    prev_buttons <= buttons;
+    prev_i2c_busy <= i2c_busy;
+    prev_uart_rx_valid <= uart_rx_valid;
+    prev_uart_tx_empty <= uart_tx_empty;
+    prev_audio_capture_wrapped <= audio_capture_wrapped;
+    prev_enable <= enable;
+
+		if (!resetn) begin
+      pending <= 0;
+      enable <= 0;
+      raster_line <= 0;
+      iomem_ready <= 0;
+		end else begin
+      // an event in the same clock as its acknowledge stays pending
+      pending <= (ack ? pending & ~iomem_wdata[NUM_EVENTS-1:0] : pending) | events;
+
+      iomem_ready <= 0;
+			if (iomem_valid && !iomem_ready) begin
+        iomem_ready <= 1;
+        if (enable_write) enable <= iomem_wdata[NUM_EVENTS-1:0];
+        if (enable_set) enable <= enable | iomem_wdata[NUM_EVENTS-1:0];
+        if (enable_clear) enable <= enable & ~iomem_wdata[NUM_EVENTS-1:0];
+        if (reg_write && iomem_addr[4:2] == 3'd3) raster_line <= iomem_wdata[8:0];
+        case (iomem_addr[4:2])
+          3'd0: iomem_rdata <= pending;
+          3'd1, 3'd4, 3'd5: iomem_rdata <= enable;
+          3'd3: iomem_rdata <= raster_line;
+          default: iomem_rdata <= 0;
+        endcase
+			end
+		end
+	end
+
+endmodule
@@ -0,0 +1,76 @@
+/*
+ * IO mapped multiply, divide and binary to BCD unit for PicoSOC, for CPUs
+ * built without ENABLE_MULDIV.  Each operation takes 32 clocks, one bit per
+ * clock; reading a result (or starting another operation) waits until done.
+ *
+ * See README.md for the registers.
+ */
+module math
+(
+  input resetn,
+  input clk,
+	input iomem_valid,
+	input [3:0]  iomem_wstrb,
+	input [31:0] iomem_addr,
+  output reg [31:0] iomem_rdata,
+  output reg iomem_ready,
+	input [31:0] iomem_wdata);
+
+  localparam OP_MUL = 2'd0, OP_DIV = 2'd1, OP_BCD = 2'd2;
+
+  reg [31:0] a, b;
+  reg [63:0] acc;    // multiply: {high, low}, divide: {remainder, quotient}, BCD: digits
+  reg [1:0] op;
+  reg [5:0] count;   // clocks left
+
+  // multiply: add b to the high half when the low bit is set, shift right
+  wire [32:0] mul_sum = {1'b0, acc[63:32]} + (acc[0] ? {1'b0, b} : 33'd0);
+
+  // divide (restoring): shift left, subtract b from the remainder if it fits
+  wire [33:0] div_diff = {1'b0, acc[63:31]} - {2'b0, b};
+
+  // binary to BCD (double dabble): add 3 to each digit over 4, shift in b's top bit
+  reg [39:0] bcd_adjusted;
+  integer i;
+  always @* begin
+    for (i = 0; i < 10; i = i + 1)
+      bcd_adjusted[i*4 +: 4] = acc[i*4 +: 4] > 4 ? acc[i*4 +: 4] + 4'd3 : acc[i*4 +: 4];
+  end
+
+	always @(posedge clk) begin
+		if (!resetn) begin
+      count <= 0;
+      iomem_ready <= 0;
+		end else begin
+      iomem_ready <= 0;
+
+      if (count != 0) begin
+        count <= count - 1;
+        case (op)
+          OP_MUL: acc <= {mul_sum, acc[31:1]};
+          OP_DIV: acc <= div_diff[33] ? {acc[62:0], 1'b0} : {div_diff[31:0], acc[30:0], 1'b1};
+          default: begin
+            acc <= {24'd0, bcd_adjusted[38:0], b[31]};
+            b <= b << 1;
+          end
+        endcase
+      end else if (iomem_valid && !iomem_ready) begin
+        iomem_ready <= 1;
+        if (|iomem_wstrb) begin
+          case (iomem_addr[4:2])
+            3'd0: a <= iomem_wdata;
+            3'd1: begin b <= iomem_wdata; acc <= {32'd0, a}; op <= OP_MUL; count <= 32; end
+            3'd2: begin b <= iomem_wdata; acc <= {32'd0, a}; op <= OP_DIV; count <= 32; end
+            3'd3: begin b <= iomem_wdata; acc <= 64'd0;      op <= OP_BCD; count <= 32; end
+          endcase
+        end
+        case (iomem_addr[4:2])
+          3'd4: iomem_rdata <= acc[31:0];
+          3'd5: iomem_rdata <= acc[63:32];
+          default: iomem_rdata <= a;
+        endcase
+      end
+		end
+	end
+
+endmodule
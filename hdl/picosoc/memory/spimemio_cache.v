@@ -0,0 +1,131 @@
+/*
+ *  spimemio_cache - direct-mapped read cache between picorv32 and spimemio
+ *
+ *  One 32-bit word per line, WORDS lines.  Data and tags live in block RAM
+ *  (256 words = 2 data RAMs + 1 tag RAM on the iCE40).
+ *
+ *  A hit costs one wait state: the block RAMs are read in the cycle valid is
+ *  first seen and the tag is compared in the next.  A miss is passed on to
+ *  spimemio in the clock after that, two clocks later than without the
+ *  cache, and the word it returns is written into the line.  Writes, and
+ *  any access while the cache is disabled or being invalidated, go straight
+ *  to spimemio without touching the cache.
+ *
+ *  Control register (cfgreg):
+ *    bit 0  enable (1 after reset)
+ *    bit 1  write 1: invalidate all lines (read: invalidate still running)
+ *    bit 2  write 1: clear the hit/miss counters
+ */
+
+module spimemio_cache #(
+	parameter integer WORDS = 256
+) (
+	input clk, resetn,
+
+	input             valid,
+	input      [ 3:0] wstrb,
+	input      [23:0] addr,
+	output            ready,
+	output     [31:0] rdata,
+
+	output            mem_valid,
+	input             mem_ready,
+	input      [31:0] mem_rdata,
+
+	input      [ 3:0] cfgreg_we,
+	input      [31:0] cfgreg_di,
+	output     [31:0] cfgreg_do,
+
+	output reg [31:0] hits,
+	output reg [31:0] misses
+);
+	localparam integer INDEX_BITS = $clog2(WORDS);
+	localparam integer TAG_BITS = 22 - INDEX_BITS;
+
+	reg [31:0] data_ram [0:WORDS-1];
+	reg [TAG_BITS:0] tag_ram [0:WORDS-1];   // {valid, tag}
+
+	reg [31:0] data_q;
+	reg [TAG_BITS:0] tag_q;
+
+	reg enabled;
+	reg invalidating;
+	reg [INDEX_BITS-1:0] invalidate_index;
+
+	reg lookup;
+	reg filling;
+
+	wire [INDEX_BITS-1:0] index = addr[INDEX_BITS+1:2];
+	wire [TAG_BITS-1:0] tag = addr[23:INDEX_BITS+2];
+
+	wire bypass = !enabled || invalidating || wstrb != 0;
+	wire hit = lookup && !bypass && tag_q == {1'b1, tag};
+	wire fill_done = filling && mem_ready;
+
+	assign mem_valid = valid && (bypass || filling);
+	assign ready = hit || (mem_valid && mem_ready);
+	assign rdata = hit ? data_q : mem_rdata;
+
+	assign cfgreg_do = {30'b0, invalidating, enabled};
+
+	always @(posedge clk) begin
+		data_q <= data_ram[index];
+		if (fill_done)
+			data_ram[index] <= mem_rdata;
+	end
+
+	always @(posedge clk) begin
+		tag_q <= tag_ram[index];
+		if (invalidating)
+			tag_ram[invalidate_index] <= 0;
+		else if (fill_done)
+			tag_ram[index] <= {1'b1, tag};
+	end
+
+	always @(posedge clk) begin
+		lookup <= 0;
+
+		if (valid && !ready && !bypass) begin
+			if (lookup)
+				filling <= 1;
+			else if (!filling)
+				lookup <= 1;
+		end
+
+		if (fill_done || !valid)
+			filling <= 0;
+
+		if (hit)
+			hits <= hits + 1;
+		if (fill_done)
+			misses <= misses + 1;
+
+		if (invalidating) begin
+			invalidate_index <= invalidate_index + 1;
+			if (&invalidate_index)
+				invalidating <= 0;
+		end
+
+		if (cfgreg_we[0]) begin
+			enabled <= cfgreg_di[0];
+			if (cfgreg_di[1]) begin
+				invalidating <= 1;
+				invalidate_index <= 0;
+			end
+			if (cfgreg_di[2]) begin
+				hits <= 0;
+				misses <= 0;
+			end
+		end
+
+		if (!resetn) begin
+			lookup <= 0;
+			filling <= 0;
+			enabled <= 1;
+			invalidating <= 1;
+			invalidate_index <= 0;
+			hits <= 0;
+			misses <= 0;
+		end
+	end
+endmodule
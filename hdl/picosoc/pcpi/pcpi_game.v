@@ -0,0 +1,74 @@
+/*
+ * picorv32 PCPI coprocessor with a few instructions for game inner loops.
+ * They use the custom-1 opcode (0101011) with funct3 000; funct7 picks the
+ * instruction.  Each takes one clock in the unit, on top of the CPU's
+ * register reads and write back.
+ *
+ * See README.md for the instructions, and firmware/custom_ops.S and
+ * libraries/pcpi for the macros that emit them.
+ */
+module pcpi_game (
+	input clk, resetn,
+
+	input             pcpi_valid,
+	input      [31:0] pcpi_insn,
+	input      [31:0] pcpi_rs1,
+	input      [31:0] pcpi_rs2,
+	output reg        pcpi_wr,
+	output reg [31:0] pcpi_rd,
+	output            pcpi_wait,
+	output reg        pcpi_ready
+);
+	localparam [6:0] OP_POPCOUNT = 7'd0, OP_FFS = 7'd1, OP_TILEADDR = 7'd2,
+	                 OP_ADDSAT16 = 7'd3, OP_BREV16 = 7'd4;
+
+	// picosoc iomem address of the video tile memory (libraries/video)
+	localparam [31:0] TILEMEM = 32'h 0520_0000;
+
+	wire insn_game = pcpi_insn[6:0] == 7'b0101011 && pcpi_insn[14:12] == 3'b000;
+
+	reg [5:0] popcount;
+	reg [5:0] ffs;
+	reg [15:0] brev16;
+	integer i;
+	always @* begin
+		popcount = 0;
+		for (i = 0; i < 32; i = i + 1)
+			popcount = popcount + pcpi_rs1[i];
+
+		// like C's ffs(): 1 + the index of the lowest set bit, 0 if none
+		ffs = 0;
+		for (i = 31; i >= 0; i = i - 1)
+			if (pcpi_rs1[i]) ffs = i + 1;
+
+		for (i = 0; i < 16; i = i + 1)
+			brev16[i] = pcpi_rs1[15 - i];
+	end
+
+	wire [32:0] sum = {1'b0, pcpi_rs1} + {1'b0, pcpi_rs2};
+
+	assign pcpi_wait = 0;
+
+	always @(posedge clk) begin
+		pcpi_ready <= 0;
+		pcpi_wr <= 0;
+		pcpi_rd <= 'bx;
+
+		if (resetn && pcpi_valid && !pcpi_ready && insn_game) begin
+			pcpi_ready <= 1;
+			pcpi_wr <= 1;
+			case (pcpi_insn[31:25])
+				OP_POPCOUNT: pcpi_rd <= popcount;
+				OP_FFS:      pcpi_rd <= ffs;
+				OP_TILEADDR: pcpi_rd <= TILEMEM | {pcpi_rs2[5:0], pcpi_rs1[5:0], 2'b00};
+				OP_ADDSAT16: pcpi_rd <= sum > 33'h ffff ? 32'h ffff : sum[31:0];
+				OP_BREV16:   pcpi_rd <= brev16;
+				default: begin
+					// not ours: let picorv32 time out and trap
+					pcpi_ready <= 0;
+					pcpi_wr <= 0;
+				end
+			endcase
+		end
+	end
+endmodule
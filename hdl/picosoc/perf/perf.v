@@ -0,0 +1,105 @@
+/*
+ * Bus performance counters for PicoSOC: watches the CPU's memory bus
+ * (picosoc's mon_* outputs) and counts the clocks the CPU spends waiting
+ * on the flash, the RAM, picosoc's own registers and each iomem slot, as
+ * well as instruction fetches, interrupts taken and clocks spent in
+ * interrupt handlers.  Software can stop the counters to read them
+ * together, and clear them.
+ *
+ * See README.md for the registers.
+ */
+module perf #(
+  parameter integer MEM_WORDS = 256
+) (
+  input resetn,
+  input clk,
+	input iomem_valid,
+	input [3:0]  iomem_wstrb,
+	input [31:0] iomem_addr,
+  output reg [31:0] iomem_rdata,
+  output reg iomem_ready,
+	input [31:0] iomem_wdata,
+
+  // the CPU's memory bus, from picosoc
+  input        mon_valid,
+  input        mon_ready,
+  input        mon_instr,
+  input [31:0] mon_addr,
+  input        mon_irq);     // in an interrupt handler
+
+  localparam FIRST_SLOT = 3, LAST_SLOT = 15;   // iomem 0x03xx_xxxx to 0x0Fxx_xxxx
+
+  reg stopped;
+  reg prev_irq;
+
+  reg [31:0] cycles;
+  reg [31:0] fetches;
+  reg [31:0] irqs;
+  reg [31:0] irq_cycles;
+  reg [31:0] flash_stall;
+  reg [31:0] ram_stall;
+  reg [31:0] soc_stall;
+  reg [31:0] iomem_stall [FIRST_SLOT:LAST_SLOT];
+
+  wire stall = mon_valid && !mon_ready;
+  wire [7:0] slot = mon_addr[31:24];
+  wire in_ram = mon_addr < 4*MEM_WORDS;
+  wire in_flash = !in_ram && slot < 8'h 02;
+
+  wire reg_write = iomem_valid && !iomem_ready && iomem_wstrb[0] && iomem_addr[7:0] == 8'h 00;
+  wire clear = reg_write && iomem_wdata[0];
+
+  integer n;
+	always @(posedge clk) begin
+    prev_irq <= mon_irq;
+
+		if (!resetn || clear) begin
+      cycles <= 0;
+      fetches <= 0;
+      irqs <= 0;
+      irq_cycles <= 0;
+      flash_stall <= 0;
+      ram_stall <= 0;
+      soc_stall <= 0;
+      for (n = FIRST_SLOT; n <= LAST_SLOT; n = n + 1)
+        iomem_stall[n] <= 0;
+    end else if (!stopped) begin
+      cycles <= cycles + 1;
+      if (mon_valid && mon_ready && mon_instr) fetches <= fetches + 1;
+      if (mon_irq && !prev_irq) irqs <= irqs + 1;
+      if (mon_irq) irq_cycles <= irq_cycles + 1;
+      if (stall) begin
+        if (in_ram) ram_stall <= ram_stall + 1;
+        else if (in_flash) flash_stall <= flash_stall + 1;
+        else if (slot == 8'h 02) soc_stall <= soc_stall + 1;
+        else if (slot >= FIRST_SLOT && slot <= LAST_SLOT) iomem_stall[slot] <= iomem_stall[slot] + 1;
+      end
+    end
+
+		if (!resetn) begin
+      stopped <= 0;
+      iomem_ready <= 0;
+		end else begin
+      if (reg_write) stopped <= iomem_wdata[1];
+
+      iomem_ready <= 0;
+			if (iomem_valid && !iomem_ready) begin
+        iomem_ready <= 1;
+        if (iomem_addr[6])
+          iomem_rdata <= iomem_addr[5:2] >= FIRST_SLOT ? iomem_stall[iomem_addr[5:2]] : 0;
+        else case (iomem_addr[5:2])
+          4'd0: iomem_rdata <= stopped << 1;
+          4'd1: iomem_rdata <= cycles;
+          4'd2: iomem_rdata <= fetches;
+          4'd3: iomem_rdata <= irqs;
+          4'd4: iomem_rdata <= irq_cycles;
+          4'd5: iomem_rdata <= flash_stall;
+          4'd6: iomem_rdata <= ram_stall;
+          4'd7: iomem_rdata <= soc_stall;
+          default: iomem_rdata <= 0;
+        endcase
+			end
+		end
+	end
+
+endmodule
@@ -36,12 +36,29 @@ module picosoc (
 	output [31:0] iomem_wdata,
 	input  [31:0] iomem_rdata,
 
+	// a second bus master (ENABLE_DMA), sharing the CPU's memory bus
+	input         dma_valid,
+	output        dma_ready,
+	input  [ 3:0] dma_wstrb,
+	input  [31:0] dma_addr,
+	input  [31:0] dma_wdata,
+	output [31:0] dma_rdata,
+
+	// the CPU's side of the memory bus, for the bus monitor (hdl/picosoc/perf)
+	output        mon_valid,
+	output        mon_ready,
+	output        mon_instr,
+	output [31:0] mon_addr,
+	output        mon_irq,      // in an interrupt handler
+
 	input  irq_5,
 	input  irq_6,
 	input  irq_7,
 
 	output ser_tx,
 	input  ser_rx,
+	output uart_rx_valid,   // a received byte is waiting (for an interrupt controller)
+	output uart_tx_empty,   // the UART's TX FIFO is empty (likewise)
 
 	output flash_csb,
 	output flash_clk,
@@ -68,6 +85,10 @@ module picosoc (
 	parameter [0:0] ENABLE_IRQ_QREGS = 0;
 	parameter [0:0] ENABLE_IRQ = 1;
 	parameter [0:0] ENABLE_TWO_STAGE_SHIFT = 1;
+	parameter [0:0] ENABLE_FLASH_CACHE = 0;
+	parameter integer FLASH_CACHE_WORDS = 256;
+	parameter [0:0] ENABLE_PCPI_GAME = 0;
+	parameter [0:0] ENABLE_DMA = 0;
 
 	parameter integer MEM_WORDS = 256;
 	parameter [31:0] STACKADDR = (4*MEM_WORDS);       // end of memory
@@ -95,6 +116,55 @@ module picosoc (
 	wire [3:0] mem_wstrb;
 	wire [31:0] mem_rdata;
 
+	wire cpu_mem_valid;
+	wire cpu_mem_ready;
+	wire [31:0] cpu_mem_addr;
+	wire [31:0] cpu_mem_wdata;
+	wire [3:0] cpu_mem_wstrb;
+	wire [31:0] cpu_mem_rdata;
+	wire [31:0] cpu_eoi;
+
+	assign mon_valid = cpu_mem_valid;
+	assign mon_ready = cpu_mem_ready;
+	assign mon_instr = mem_instr;
+	assign mon_addr = cpu_mem_addr;
+	assign mon_irq = |cpu_eoi;
+
+	// the CPU and the DMA engine take turns on the memory bus
+	generate if (ENABLE_DMA) begin
+		iomem_arbiter dma_arbiter (
+			.clk         (clk          ),
+			.resetn      (resetn       ),
+			.a_valid     (cpu_mem_valid),
+			.a_ready     (cpu_mem_ready),
+			.a_wstrb     (cpu_mem_wstrb),
+			.a_addr      (cpu_mem_addr ),
+			.a_wdata     (cpu_mem_wdata),
+			.a_rdata     (cpu_mem_rdata),
+			.b_valid     (dma_valid    ),
+			.b_ready     (dma_ready    ),
+			.b_wstrb     (dma_wstrb    ),
+			.b_addr      (dma_addr     ),
+			.b_wdata     (dma_wdata    ),
+			.b_rdata     (dma_rdata    ),
+			.iomem_valid (mem_valid    ),
+			.iomem_ready (mem_ready    ),
+			.iomem_wstrb (mem_wstrb    ),
+			.iomem_addr  (mem_addr     ),
+			.iomem_wdata (mem_wdata    ),
+			.iomem_rdata (mem_rdata    )
+		);
+	end else begin
+		assign mem_valid = cpu_mem_valid;
+		assign cpu_mem_ready = mem_ready;
+		assign mem_wstrb = cpu_mem_wstrb;
+		assign mem_addr = cpu_mem_addr;
+		assign mem_wdata = cpu_mem_wdata;
+		assign cpu_mem_rdata = mem_rdata;
+		assign dma_ready = 0;
+		assign dma_rdata = 0;
+	end endgenerate
+
 	wire spimem_ready;
 	wire [31:0] spimem_rdata;
 
@@ -116,12 +186,36 @@ module picosoc (
 	wire [31:0] simpleuart_reg_dat_do;
 	wire        simpleuart_reg_dat_wait;
 
+	wire        simpleuart_reg_sta_sel = mem_valid && (mem_addr == 32'h 0200_000c);
+	wire [31:0] simpleuart_reg_sta_do;
+
+	wire        flash_cache_cfgreg_sel = mem_valid && (mem_addr == 32'h 0200_0010);
+	wire [31:0] flash_cache_cfgreg_do;
+
+	wire        flash_cache_hits_sel = mem_valid && (mem_addr == 32'h 0200_0014);
+	wire [31:0] flash_cache_hits;
+
+	wire        flash_cache_misses_sel = mem_valid && (mem_addr == 32'h 0200_0018);
+	wire [31:0] flash_cache_misses;
+
 	assign mem_ready = (iomem_valid && iomem_ready) || spimem_ready || ram_ready || spimemio_cfgreg_sel ||
-			simpleuart_reg_div_sel || (simpleuart_reg_dat_sel && !simpleuart_reg_dat_wait);
+			simpleuart_reg_div_sel || (simpleuart_reg_dat_sel && !simpleuart_reg_dat_wait) || simpleuart_reg_sta_sel ||
+			flash_cache_cfgreg_sel || flash_cache_hits_sel || flash_cache_misses_sel;
 
 	assign mem_rdata = (iomem_valid && iomem_ready) ? iomem_rdata : spimem_ready ? spimem_rdata : ram_ready ? ram_rdata :
 			spimemio_cfgreg_sel ? spimemio_cfgreg_do : simpleuart_reg_div_sel ? simpleuart_reg_div_do :
-			simpleuart_reg_dat_sel ? simpleuart_reg_dat_do : 32'h 0000_0000;
+			simpleuart_reg_dat_sel ? simpleuart_reg_dat_do : simpleuart_reg_sta_sel ? simpleuart_reg_sta_do :
+			flash_cache_cfgreg_sel ? flash_cache_cfgreg_do :
+			flash_cache_hits_sel ? flash_cache_hits : flash_cache_misses_sel ? flash_cache_misses : 32'h 0000_0000;
+
+	wire        pcpi_valid;
+	wire [31:0] pcpi_insn;
+	wire [31:0] pcpi_rs1;
+	wire [31:0] pcpi_rs2;
+	wire        pcpi_wr;
+	wire [31:0] pcpi_rd;
+	wire        pcpi_wait;
+	wire        pcpi_ready;
 
 	picorv32 #(
 		.STACKADDR(STACKADDR),
@@ -134,27 +228,94 @@ module picosoc (
 		.ENABLE_DIV(ENABLE_MULDIV),
 		.ENABLE_IRQ(ENABLE_IRQ),
 		.ENABLE_IRQ_QREGS(ENABLE_IRQ_QREGS),
-		.TWO_STAGE_SHIFT(ENABLE_TWO_STAGE_SHIFT)
+		.TWO_STAGE_SHIFT(ENABLE_TWO_STAGE_SHIFT),
+		.ENABLE_PCPI(ENABLE_PCPI_GAME)
 	) cpu (
 		.clk         (clk        ),
 		.resetn      (resetn     ),
-		.mem_valid   (mem_valid  ),
+		.mem_valid   (cpu_mem_valid),
 		.mem_instr   (mem_instr  ),
-		.mem_ready   (mem_ready  ),
-		.mem_addr    (mem_addr   ),
-		.mem_wdata   (mem_wdata  ),
-		.mem_wstrb   (mem_wstrb  ),
-		.mem_rdata   (mem_rdata  ),
-		.irq         (irq        )
+		.mem_ready   (cpu_mem_ready),
+		.mem_addr    (cpu_mem_addr),
+		.mem_wdata   (cpu_mem_wdata),
+		.mem_wstrb   (cpu_mem_wstrb),
+		.mem_rdata   (cpu_mem_rdata),
+		.pcpi_valid  (pcpi_valid ),
+		.pcpi_insn   (pcpi_insn  ),
+		.pcpi_rs1    (pcpi_rs1   ),
+		.pcpi_rs2    (pcpi_rs2   ),
+		.pcpi_wr     (pcpi_wr    ),
+		.pcpi_rd     (pcpi_rd    ),
+		.pcpi_wait   (pcpi_wait  ),
+		.pcpi_ready  (pcpi_ready ),
+		.irq         (irq        ),
+		.eoi         (cpu_eoi    )
 	);
 
+	generate if (ENABLE_PCPI_GAME) begin
+		pcpi_game pcpi_game (
+			.clk        (clk       ),
+			.resetn     (resetn    ),
+			.pcpi_valid (pcpi_valid),
+			.pcpi_insn  (pcpi_insn ),
+			.pcpi_rs1   (pcpi_rs1  ),
+			.pcpi_rs2   (pcpi_rs2  ),
+			.pcpi_wr    (pcpi_wr   ),
+			.pcpi_rd    (pcpi_rd   ),
+			.pcpi_wait  (pcpi_wait ),
+			.pcpi_ready (pcpi_ready)
+		);
+	end else begin
+		assign pcpi_wr = 0;
+		assign pcpi_rd = 0;
+		assign pcpi_wait = 0;
+		assign pcpi_ready = 0;
+	end endgenerate
+
+	wire        flash_valid = mem_valid && mem_addr >= 4*MEM_WORDS && mem_addr < 32'h 0200_0000;
+
+	wire        spimemio_valid;
+	wire        spimemio_ready;
+	wire [31:0] spimemio_rdata;
+
+	generate if (ENABLE_FLASH_CACHE) begin
+		spimemio_cache #(.WORDS(FLASH_CACHE_WORDS)) flash_cache (
+			.clk       (clk),
+			.resetn    (resetn),
+
+			.valid     (flash_valid),
+			.wstrb     (mem_wstrb),
+			.addr      (mem_addr[23:0]),
+			.ready     (spimem_ready),
+			.rdata     (spimem_rdata),
+
+			.mem_valid (spimemio_valid),
+			.mem_ready (spimemio_ready),
+			.mem_rdata (spimemio_rdata),
+
+			.cfgreg_we (flash_cache_cfgreg_sel ? mem_wstrb : 4'b 0000),
+			.cfgreg_di (mem_wdata),
+			.cfgreg_do (flash_cache_cfgreg_do),
+
+			.hits      (flash_cache_hits),
+			.misses    (flash_cache_misses)
+		);
+	end else begin
+		assign spimemio_valid = flash_valid;
+		assign spimem_ready = spimemio_ready;
+		assign spimem_rdata = spimemio_rdata;
+		assign flash_cache_cfgreg_do = 0;
+		assign flash_cache_hits = 0;
+		assign flash_cache_misses = 0;
+	end endgenerate
+
 	spimemio spimemio (
 		.clk    (clk),
 		.resetn (resetn),
-		.valid  (mem_valid && mem_addr >= 4*MEM_WORDS && mem_addr < 32'h 0200_0000),
-		.ready  (spimem_ready),
+		.valid  (spimemio_valid),
+		.ready  (spimemio_ready),
 		.addr   (mem_addr[23:0]),
-		.rdata  (spimem_rdata),
+		.rdata  (spimemio_rdata),
 
 		.flash_csb    (flash_csb   ),
 		.flash_clk    (flash_clk   ),
@@ -194,7 +355,10 @@ module picosoc (
 		.reg_dat_re  (simpleuart_reg_dat_sel && !mem_wstrb),
 		.reg_dat_di  (mem_wdata),
 		.reg_dat_do  (simpleuart_reg_dat_do),
-		.reg_dat_wait(simpleuart_reg_dat_wait)
+		.reg_dat_wait(simpleuart_reg_dat_wait),
+		.reg_sta_do  (simpleuart_reg_sta_do),
+		.recv_valid  (uart_rx_valid),
+		.tx_empty    (uart_tx_empty)
 	);
 
 	always @(posedge clk)
@@ -1,6 +1,7 @@
 
-module sdcard
-(
+module sdcard #(
+  parameter integer SYS_CLK_HZ = 16000000
+) (
   input resetn,
   input clk,
   input iomem_valid,
@@ -12,12 +13,13 @@ module sdcard
   inout SD_MOSI,
   inout SD_MISO,
   inout SD_SCK,
-  inout SD_CS);
+  inout SD_CS,
+  output done);         // a clock as each transfer ends (for the interrupt controller)
 
   reg spi_wr, spi_rd;
   reg [31:0] spi_rdata;
   reg spi_ready;
-  spi_master #(.CLOCK_FREQ_HZ(16000000), .CS_LENGTH(1)) sd (
+  spi_master #(.CLOCK_FREQ_HZ(SYS_CLK_HZ), .CS_LENGTH(1)) sd (
       .clk(clk),
       .resetn(resetn),
       .ctrl_wr(spi_wr),
@@ -32,6 +34,8 @@ module sdcard
       .CS(SD_CS));
 
 
+  assign done = spi_ready;
+
   always @(posedge clk) begin
     spi_wr <= 0;
     spi_rd <= 0;
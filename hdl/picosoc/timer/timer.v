@@ -0,0 +1,118 @@
+/*
+ * Timer peripheral for PicoSOC: free-running clock and microsecond
+ * counters, and compare channels on the microsecond counter.  A channel
+ * fires when the counter reaches its compare value, or is already past it
+ * (by under 2^31), so a deadline that has gone fires at once.  Firing sets
+ * the channel's status bit and pulses match (for the interrupt controller),
+ * then moves its compare value on by its period, or disables the channel
+ * if the period is 0.
+ *
+ * See README.md for the registers.
+ */
+module timer #(
+  parameter integer SYS_CLK_HZ = 16000000
+) (
+  input resetn,
+  input clk,
+	input iomem_valid,
+	input [3:0]  iomem_wstrb,
+	input [31:0] iomem_addr,
+  output reg [31:0] iomem_rdata,
+  output reg iomem_ready,
+	input [31:0] iomem_wdata,
+  output reg match);
+
+  localparam CHANNELS = 4;
+  localparam CLOCKS_PER_US = SYS_CLK_HZ / 1000000;
+
+  reg [31:0] cycles;
+  reg [31:0] us;
+  reg [5:0] us_prescale;   // clocks into the current microsecond
+
+  reg [CHANNELS-1:0] status;
+  reg [CHANNELS-1:0] enable;
+  reg [31:0] compare [0:CHANNELS-1];
+  reg [31:0] period [0:CHANNELS-1];
+
+  wire us_tick = us_prescale == CLOCKS_PER_US - 1;
+
+  // channels at or past their compare value this clock
+  wire [31:0] us_next = us + 1;
+  reg [31:0] late;
+  reg [CHANNELS-1:0] fire;
+  integer n;
+  always @* begin
+    for (n = 0; n < CHANNELS; n = n + 1) begin
+      late = us_next - compare[n];
+      fire[n] = us_tick && enable[n] && !late[31];
+    end
+  end
+
+  wire reg_write = iomem_valid && !iomem_ready && iomem_wstrb[0];
+  wire [2:0] channel = iomem_addr[5:3] - 3'd2;     // 0x10 + 8 * channel
+  wire channel_addr = !iomem_addr[6] && iomem_addr[5:4] != 2'b00;
+
+  // one-shot channels firing this clock, which disable themselves
+  reg [CHANNELS-1:0] spent;
+  integer m;
+  always @* begin
+    for (m = 0; m < CHANNELS; m = m + 1)
+      spent[m] = fire[m] && period[m] == 0;
+  end
+
+  // enable writes: the whole register, or 1s set (0x40) or clear (0x44)
+  // bits, which can't undo a channel disabling itself in the same clock
+  wire enable_write = reg_write && !iomem_addr[6] && !channel_addr && iomem_addr[3:2] == 2'd3;
+  wire enable_set   = reg_write && iomem_addr[6] && iomem_addr[3:2] == 2'd0;
+  wire enable_clear = reg_write && iomem_addr[6] && iomem_addr[3:2] == 2'd1;
+  wire [CHANNELS-1:0] enable_left = enable & ~spent;
+
+	always @(posedge clk) begin
+		if (!resetn) begin
+      cycles <= 0;
+      us <= 0;
+      us_prescale <= 0;
+      status <= 0;
+      enable <= 0;
+      match <= 0;
+      iomem_ready <= 0;
+		end else begin
+      cycles <= cycles + 1;
+      us_prescale <= us_tick ? 0 : us_prescale + 1;
+      if (us_tick) us <= us_next;
+
+      match <= |fire;
+      for (n = 0; n < CHANNELS; n = n + 1) begin
+        if (fire[n] && period[n] != 0)
+          compare[n] <= compare[n] + period[n];
+      end
+
+      enable <= enable_write ? iomem_wdata[CHANNELS-1:0] :
+                enable_set   ? enable_left | iomem_wdata[CHANNELS-1:0] :
+                enable_clear ? enable_left & ~iomem_wdata[CHANNELS-1:0] : enable_left;
+
+      // firing wins over a write to the same status bit
+      status <= (reg_write && iomem_addr[6:2] == 5'd2 ? status & ~iomem_wdata[CHANNELS-1:0] : status) | fire;
+
+      iomem_ready <= 0;
+			if (iomem_valid && !iomem_ready) begin
+        iomem_ready <= 1;
+        if (iomem_wstrb[0] && channel_addr) begin
+          if (iomem_addr[2]) period[channel] <= iomem_wdata;
+          else compare[channel] <= iomem_wdata;
+        end
+        if (channel_addr)
+          iomem_rdata <= iomem_addr[2] ? period[channel] : compare[channel];
+        else if (iomem_addr[6])
+          iomem_rdata <= enable;
+        else case (iomem_addr[3:2])
+          2'd0: iomem_rdata <= cycles;
+          2'd1: iomem_rdata <= us;
+          2'd2: iomem_rdata <= status;
+          2'd3: iomem_rdata <= enable;
+        endcase
+			end
+		end
+	end
+
+endmodule
@@ -17,7 +17,14 @@
  *
  */
 
-module simpleuart (
+// Bytes written to the data register wait in a TX FIFO of 2**TX_FIFO_BITS
+// bytes, so a write only stalls the CPU while it is full.  The status
+// register reads the free space, and tx_empty goes high as the FIFO
+// empties, for an interrupt to refill it.
+
+module simpleuart #(
+	parameter integer TX_FIFO_BITS = 4
+) (
 	input clk,
 	input resetn,
 
@@ -32,7 +39,10 @@ module simpleuart (
 	input         reg_dat_re,
 	input  [31:0] reg_dat_di,
 	output [31:0] reg_dat_do,
-	output        reg_dat_wait
+	output        reg_dat_wait,
+	output [31:0] reg_sta_do,
+	output        recv_valid,
+	output        tx_empty
 );
 	reg [31:0] cfg_divider;
 
@@ -47,10 +57,24 @@ module simpleuart (
 	reg [31:0] send_divcnt;
 	reg send_dummy;
 
+	reg [7:0] tx_fifo [0:(1<<TX_FIFO_BITS)-1];
+	reg [TX_FIFO_BITS-1:0] tx_head, tx_tail;
+	reg [TX_FIFO_BITS:0] tx_count;
+
+	wire tx_full = tx_count == 1 << TX_FIFO_BITS;
+	wire tx_push = reg_dat_we && !tx_full;
+	wire tx_pop = tx_count != 0 && !send_bitcnt && !send_dummy;
+
+	assign tx_empty = tx_count == 0;
+
 	assign reg_div_do = cfg_divider;
 
-	assign reg_dat_wait = reg_dat_we && (send_bitcnt || send_dummy);
+	assign reg_dat_wait = reg_dat_we && tx_full;
+	// bit 8: everything sent; bits 7:0: bytes the FIFO has room for
+	wire [8:0] tx_free = (1 << TX_FIFO_BITS) - tx_count;
+	assign reg_sta_do = {23'd0, tx_empty && !send_bitcnt, tx_free[7:0]};
 	assign reg_dat_do = recv_buf_valid ? recv_buf_data : ~0;
+	assign recv_valid = recv_buf_valid;
 
 	always @(posedge clk) begin
 		if (!resetn) begin
@@ -106,6 +130,22 @@ module simpleuart (
 
 	assign ser_tx = send_pattern[0];
 
+	always @(posedge clk) begin
+		if (tx_push)
+			tx_fifo[tx_head] <= reg_dat_di[7:0];
+		if (!resetn) begin
+			tx_head <= 0;
+			tx_tail <= 0;
+			tx_count <= 0;
+		end else begin
+			if (tx_push)
+				tx_head <= tx_head + 1;
+			if (tx_pop)
+				tx_tail <= tx_tail + 1;
+			tx_count <= tx_count + tx_push - tx_pop;
+		end
+	end
+
 	always @(posedge clk) begin
 		if (reg_div_we)
 			send_dummy <= 1;
@@ -122,8 +162,8 @@ module simpleuart (
 				send_divcnt <= 0;
 				send_dummy <= 0;
 			end else
-			if (reg_dat_we && !send_bitcnt) begin
-				send_pattern <= {1'b1, reg_dat_di[7:0], 1'b0};
+			if (tx_pop) begin
+				send_pattern <= {1'b1, tx_fifo[tx_tail], 1'b0};
 				send_bitcnt <= 10;
 				send_divcnt <= 0;
 			end else
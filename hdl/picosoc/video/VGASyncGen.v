@@ -22,11 +22,14 @@
 //////////////////////////////////////////////////////////////////////////////////
 module VGASyncGen (
   input wire       clk,           // Input clock (12Mhz or 16Mhz)
+  input wire       pix_en,        // Count a pixel this clock (always 1 at 16MHz)
   output wire      hsync,         // Horizontal sync out
   output wire      vsync,         // Vertical sync out
   output reg [9:0] x_px,          // X position for actual pixel.
   output reg [9:0] y_px,          // Y position for actual pixel.
-  output wire      activevideo    // Video is actived.
+  output wire      activevideo,   // Video is actived.
+  output wire      vblank,        // In the vertical blanking lines.
+  output wire [9:0] line_px       // Line being drawn, through its horizontal blanking too.
 );
 
     /////////////////////////////////////////////////////////////
@@ -92,6 +95,7 @@ module VGASyncGen (
 
     // Counting pixels.
     always @(posedge clk)
+    if (pix_en)
     begin
         // Keep counting until the end of the line.
         if (hc < hpixels - 1)
@@ -114,6 +118,8 @@ module VGASyncGen (
     assign hsync = (hc >= hfp && hc < hfp + hpulse) ? 1'b0 : 1'b1;
     assign vsync = (vc >= vfp && vc < vfp + vpulse) ? 1'b0 : 1'b1;
     assign activevideo = (hc >= blackH) && (vc >= blackV) ? 1'b1 : 1'b0; //&& (hc < blackH + activeHvideo) && (vc < blackV + activeVvideo) ? 1'b1 : 1'b0;
+    assign vblank = vc < blackV;
+    assign line_px = vc - blackV;
 //    assign endframe = (hc == hpixels-1 && vc == vlines-1) ? 1'b1 : 1'b0 ;
 
     // Generate new pixel position.
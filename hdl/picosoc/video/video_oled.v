@@ -1,6 +1,7 @@
 
-module video_oled
-(
+module video_oled #(
+  parameter integer SYS_CLK_HZ = 16000000
+) (
   input resetn,
   input clk,
   input iomem_valid,
@@ -18,7 +19,7 @@ module video_oled
   reg spi_wr, spi_rd;
   reg [31:0] spi_rdata;
   reg spi_ready;
-  spi_oled #(.CLOCK_FREQ_HZ(16000000)) oled (
+  spi_oled #(.CLOCK_FREQ_HZ(SYS_CLK_HZ)) oled (
       .clk(clk),
       .resetn(resetn),
       .ctrl_wr(spi_wr),
@@ -6,14 +6,18 @@
  *  tile memory mapped to 0x0520_0000
  */
 
-module video_vga
-(
+module video_vga #(
+  parameter integer SYS_CLK_HZ = 16000000
+) (
   input resetn,
   input clk,
   input iomem_valid,
   input [3:0]  iomem_wstrb,
   input [31:0] iomem_addr,
   input [31:0] iomem_wdata,
+  output vblank,      // for the interrupt controller: vertical blanking, or
+                      // a pulse as each LCD frame starts
+  output [8:0] line,  // line being drawn (on the LCD, the column)
 `ifdef ili9341
   output reg       nreset,
   output reg       cmd_data, // 1 => Data, 0 => Command
@@ -187,9 +191,12 @@ module video_vga
    
  wire video_active = 1;
 
-   ili9341 lcd (
+   assign vblank = reset_cursor;
+   assign line = xpos[8:0];
+
+   ili9341 #(.clk_freq(SYS_CLK_HZ)) lcd (
                 .resetn(resetn),
-                .clk_16MHz (clk),
+                .clk (clk),
                 .nreset (nreset),
                 .cmd_data (cmd_data),
                 .write_edge (write_edge),
@@ -226,13 +233,29 @@ module video_vga
       end
    end
 `else
+  // the VGA timings are for 16MHz: at a faster system clock (a multiple
+  // of 16MHz) the pixel position moves every SYS_CLK_HZ / 16MHz clocks
+  localparam PIX_DIV = SYS_CLK_HZ / 16000000;
+  reg [1:0] pix_count = 0;
+  wire pix_en = pix_count == PIX_DIV - 1;
+
+  always @(posedge clk)
+    pix_count <= pix_en ? 0 : pix_count + 1;
+
+  wire [9:0] vga_line;
+  assign line = vga_line[9:1];  // lines are doubled, like half_ypos
+
   VGASyncGen vga_generator(
     .clk(clk),
+    .pix_en(pix_en),
     .hsync(vga_hsync),
     .vsync(vga_vsync),
     .x_px(xpos),
     .y_px(ypos),
-    .activevideo(video_active)
+    .activevideo(video_active),
+    .vblank(vblank),
+    .line_px(vga_line)
   );
+
 `endif
 endmodule
@@ -0,0 +1,81 @@
+/*
+ * Posted write buffer for the iomem bus: takes the CPU's peripheral
+ * stores into a small FIFO and acknowledges them in the same clock, then
+ * writes them out in order while the CPU gets on.  A read waits for the
+ * FIFO to empty before it goes out, so it sees every earlier store.
+ * Reading or writing the barrier register (0x0Exx_xxxx) does only that,
+ * touching no peripheral.
+ *
+ * See README.md.
+ */
+module write_buffer #(
+	parameter integer DEPTH_BITS = 2,             // 4 stores
+	parameter [7:0] BARRIER_SLOT = 8'h 0e
+) (
+	input clk,
+	input resetn,
+
+	// from picosoc
+	input             cpu_valid,
+	output            cpu_ready,
+	input      [ 3:0] cpu_wstrb,
+	input      [31:0] cpu_addr,
+	input      [31:0] cpu_wdata,
+	output     [31:0] cpu_rdata,
+
+	// to the peripherals
+	output        iomem_valid,
+	input         iomem_ready,
+	output [ 3:0] iomem_wstrb,
+	output [31:0] iomem_addr,
+	output [31:0] iomem_wdata,
+	input  [31:0] iomem_rdata
+);
+	localparam DEPTH = 1 << DEPTH_BITS;
+
+	reg [ 3:0] fifo_wstrb [0:DEPTH-1];
+	reg [31:0] fifo_addr  [0:DEPTH-1];
+	reg [31:0] fifo_wdata [0:DEPTH-1];
+
+	// one bit wider than an index, so that full and empty differ
+	reg [DEPTH_BITS:0] head, tail;
+	wire [DEPTH_BITS-1:0] head_idx = head[DEPTH_BITS-1:0];
+	wire [DEPTH_BITS-1:0] tail_idx = tail[DEPTH_BITS-1:0];
+
+	wire empty = head == tail;
+	wire full = head_idx == tail_idx && !empty;
+
+	wire cpu_write = cpu_valid && |cpu_wstrb;
+	wire cpu_read = cpu_valid && !cpu_wstrb;
+	wire barrier_sel = cpu_addr[31:24] == BARRIER_SLOT;
+
+	// nothing answers the barrier slot, so a store to it is not buffered
+	wire push = cpu_write && !barrier_sel && !full;
+	wire pop = !empty && iomem_ready;
+
+	// the FIFO's oldest store goes out first; a read only once it is empty
+	assign iomem_valid = !empty || (cpu_read && !barrier_sel);
+	assign iomem_wstrb = empty ? cpu_wstrb : fifo_wstrb[head_idx];
+	assign iomem_addr  = empty ? cpu_addr  : fifo_addr[head_idx];
+	assign iomem_wdata = empty ? cpu_wdata : fifo_wdata[head_idx];
+
+	assign cpu_ready = push || (cpu_valid && barrier_sel && empty) ||
+	                   (cpu_read && empty && iomem_ready);
+	assign cpu_rdata = barrier_sel ? 32'h 0 : iomem_rdata;
+
+	always @(posedge clk) begin
+		if (!resetn) begin
+			head <= 0;
+			tail <= 0;
+		end else begin
+			if (push) begin
+				fifo_wstrb[tail_idx] <= cpu_wstrb;
+				fifo_addr[tail_idx] <= cpu_addr;
+				fifo_wdata[tail_idx] <= cpu_wdata;
+				tail <= tail + 1;
+			end
+			if (pop)
+				head <= head + 1;
+		end
+	end
+endmodule
@@ -1,3 +1,89 @@
+# CPU profile: the picorv32 options built into the hardware, and the
+# matching -march for the firmware.  A game may set CPU_PROFILE before
+# including this file, or on the command line ("make clean" first: nothing
+# else rebuilds when it changes).  "make report" shows what a profile costs.
+#   small       RV32I, shifts one bit per clock (the default)
+#   barrel      RV32I with the barrel shifter
+#   compressed  RV32IC: smaller code, so fewer bytes fetched from flash
+#   fast        RV32IMC with the barrel shifter and the multiplier/divider
+CPU_PROFILE ?= small
+
+ifeq ($(CPU_PROFILE),small)
+MARCH = rv32i
+CPU_DEFINES =
+else ifeq ($(CPU_PROFILE),barrel)
+MARCH = rv32i
+CPU_DEFINES = -Dcpu_barrel_shifter
+else ifeq ($(CPU_PROFILE),compressed)
+MARCH = rv32ic
+CPU_DEFINES = -Dcpu_compressed
+else ifeq ($(CPU_PROFILE),fast)
+MARCH = rv32imc
+CPU_DEFINES = -Dcpu_barrel_shifter -Dcpu_compressed -Dcpu_muldiv
+else
+$(error unknown CPU_PROFILE "$(CPU_PROFILE)": small, barrel, compressed or fast)
+endif
+
+# System clock in MHz, for the hardware and (as SYS_CLK_HZ) the firmware.
+# 16 is the board's oscillator as it is; 24, 32, 40 and 48 come from the
+# iCE40 PLL.  VGA needs a multiple of 16.  hardware.bin is not made if
+# icetime finds the design too slow for it ("make clean" first when
+# changing it, as for CPU_PROFILE).
+SYS_CLK_MHZ ?= 16
+
+ifeq ($(filter $(SYS_CLK_MHZ),16 24 32 40 48),)
+$(error unsupported SYS_CLK_MHZ "$(SYS_CLK_MHZ)": 16, 24, 32, 40 or 48)
+endif
+ifneq ($(and $(filter -Dvga,$(DEFINES)),$(filter $(SYS_CLK_MHZ),24 40)),)
+$(error VGA timing needs SYS_CLK_MHZ 16, 32 or 48)
+endif
+
+# Bus performance counters: PERF=1 builds hdl/picosoc/perf into the
+# hardware and libraries/perf into the firmware, and defines perf for the
+# C code, so a game can print where its clocks go (perf_report()).  "make
+# clean" first, as for CPU_PROFILE.
+PERF ?= 0
+
+ifeq ($(PERF),1)
+VERILOG_FILES += $(HDL_DIR)/picosoc/perf/perf.v
+C_FILES += $(INCLUDE_DIR)/perf/perf.c
+DEFINES += -Dperf
+CFLAGS += -Dperf
+endif
+
+# Messages compiled into the firmware by libraries/log: NONE, ERROR, WARN,
+# INFO or DEBUG, and everything more severe ("make clean" first).
+LOG_LEVEL ?= INFO
+
+ifeq ($(filter $(LOG_LEVEL),NONE ERROR WARN INFO DEBUG),)
+$(error unknown LOG_LEVEL "$(LOG_LEVEL)": NONE, ERROR, WARN, INFO or DEBUG)
+endif
+CFLAGS += -DLOG_LEVEL=LOG_LEVEL_$(LOG_LEVEL)
+
+# Firmware build: BUILD=debug (the default) compiles without optimisation,
+# so the code follows the source line by line; BUILD=release compiles with
+# RELEASE_OPT (-Os, or -O2 for speed) and link-time optimisation, and the
+# linker drops the functions and data nothing uses.  "make size" shows the
+# result, "make bench" compares the two.  "make clean" first, as for
+# CPU_PROFILE.
+BUILD ?= debug
+RELEASE_OPT ?= -Os
+
+ifeq ($(BUILD),debug)
+OPT_CFLAGS =
+OPT_LDFLAGS =
+else ifeq ($(BUILD),release)
+# no memcpy or memset to turn loops into (-nostdlib)
+OPT_CFLAGS = $(RELEASE_OPT) -flto -fdata-sections -fno-tree-loop-distribute-patterns
+OPT_LDFLAGS = -Wl,--gc-sections
+else
+$(error unknown BUILD "$(BUILD)": debug or release)
+endif
+
+SIZE = /opt/riscv32i/bin/riscv32-unknown-elf-size
+
+XIPORDER = $(HDL_DIR)/../tools/xiporder/xiporder -c $(SYS_CLK_MHZ) $(if $(findstring cpu_barrel_shifter,$(CPU_DEFINES)),-b)
+
 upload: hardware.bin firmware.bin
 	tinyprog -p hardware.bin -u firmware.bin
 
@@ -5,22 +91,75 @@ game: hardware.bin firmware.bin
 	cat hardware.bin $(HDL_DIR)/padding.bin firmware.bin >game.bin
 
 hardware.blif: $(VERILOG_FILES) 
-	yosys -f "verilog $(DEFINES)" -ql hardware.log -p 'synth_ice40 -top top -blif hardware.blif' $^
+	yosys -f "verilog $(DEFINES) $(CPU_DEFINES) -DSYS_CLK_MHZ=$(SYS_CLK_MHZ)" -ql hardware.log -p 'synth_ice40 -top top -blif hardware.blif' $^
 
 hardware.asc: $(PCF_FILE) hardware.blif
 	arachne-pnr -d 8k -P cm81 -o hardware.asc -p $(PCF_FILE) hardware.blif
 
 hardware.bin: hardware.asc
-	icetime -d hx8k -c 16 -mtr hardware.rpt hardware.asc
+	icetime -d hx8k -c $(SYS_CLK_MHZ) -mtr hardware.rpt hardware.asc
+	@awk -v mhz=$(SYS_CLK_MHZ) '/Total path delay/ { gsub(/[()]/, ""); fmax = $$6 } \
+		END { if (fmax + 0 < mhz) { print "icetime: " fmax + 0 " MHz is below SYS_CLK_MHZ=" mhz; exit 1 } }' hardware.rpt
 	icepack hardware.asc hardware.bin
 
-firmware.elf: $(C_FILES) 
-	/opt/riscv32i/bin/riscv32-unknown-elf-gcc -march=rv32i -mabi=ilp32 -nostartfiles -Wl,-Bstatic,-T,$(LDS_FILE),--strip-debug,-Map=firmware.map,--cref -fno-zero-initialized-in-bss -ffreestanding -nostdlib -o firmware.elf -I$(INCLUDE_DIR)  $(START_FILE) $(C_FILES)
+firmware.elf: $(C_FILES) $(if $(IOCPU_C_FILES),iocpu.bin)
+	/opt/riscv32i/bin/riscv32-unknown-elf-gcc -march=$(MARCH) -mabi=ilp32 -nostartfiles -Wl,-Bstatic,-T,$(LDS_FILE),--strip-debug,-Map=firmware.map,--cref -ffreestanding -nostdlib -ffunction-sections -DSYS_CLK_HZ=$(SYS_CLK_MHZ)000000 -L$(FIRMWARE_DIR) $(OPT_CFLAGS) $(OPT_LDFLAGS) -o firmware.elf -I$(INCLUDE_DIR) $(CFLAGS) $(START_FILE) $(C_FILES)
+	@if [ -x $(HDL_DIR)/../tools/xiporder/xiporder ]; then $(XIPORDER) -m -f 250 firmware.elf; fi
+
+# program for the IO coprocessor (hardware built with -Diocpu): a game lists
+# its sources in IOCPU_C_FILES, and $(INCLUDE_DIR)/iocpu/iocpu_image.S in
+# C_FILES to carry iocpu.bin (see hdl/picosoc/iocpu/README.md)
+iocpu.elf: $(IOCPU_C_FILES)
+	/opt/riscv32i/bin/riscv32-unknown-elf-gcc -march=rv32i -mabi=ilp32 -Os -nostartfiles -Wl,-Bstatic,-T,$(FIRMWARE_DIR)/iocpu/sections.lds,--strip-debug,-Map=iocpu.map,--gc-sections -ffreestanding -nostdlib -ffunction-sections -DIOCPU_SIDE -DSYS_CLK_HZ=$(SYS_CLK_MHZ)000000 -o iocpu.elf -I$(INCLUDE_DIR) $(IOCPU_CFLAGS) $(FIRMWARE_DIR)/iocpu/start.S $(IOCPU_C_FILES)
+
+iocpu.bin: iocpu.elf
+	/opt/riscv32i/bin/riscv32-unknown-elf-objcopy -O binary iocpu.elf iocpu.bin
+
+# profile firmware.elf on a host model and write function_order.ld, used
+# by the next link (see tools/xiporder)
+order: firmware.elf
+	$(XIPORDER) -f 250 firmware.elf
+
+# logic used by the last synthesis, the timing icetime found, and clocks per
+# 50Hz frame and RAM use for firmware.elf on the host model (see
+# tools/xiporder)
+report: hardware.blif firmware.elf
+	@echo "CPU profile $(CPU_PROFILE): -march=$(MARCH) $(CPU_DEFINES), $(SYS_CLK_MHZ)MHz"
+	@awk '/=== top ===/ { n = 0 } /SB_LUT4|SB_CARRY|SB_DFF|SB_RAM40_4K/ { cell[n++] = $$0 } END { for (i = 0; i < n; i++) print cell[i] }' hardware.log
+	@if [ -f hardware.rpt ]; then grep "Total path delay" hardware.rpt; fi
+	@$(XIPORDER) -r -f 250 firmware.elf
+	@$(XIPORDER) -m -f 250 firmware.elf
+
+# flash and RAM the firmware takes: text is code and constants in flash,
+# data is .ramfunc and .data (in flash, and copied to RAM), bss is RAM only
+size: firmware.elf
+	@echo "BUILD=$(BUILD)$(if $(OPT_CFLAGS), $(OPT_CFLAGS))"
+	@$(SIZE) firmware.elf
+
+# size and host model clocks for the debug and release builds, rebuilding
+# the firmware each time (leaves the release build).  The games wait for
+# their next tick in a counting loop, so clocks/frame stays the same: compare
+# the share taken by interrupts, clocks/insn and the flash commands per frame.
+bench:
+	@for build in debug release; do \
+		rm -f firmware.elf firmware.bin firmware.map; \
+		$(MAKE) --no-print-directory BUILD=$$build firmware.elf >/dev/null || exit 1; \
+		$(MAKE) --no-print-directory BUILD=$$build size; \
+		$(XIPORDER) -r -f 250 firmware.elf; \
+	done
+
+# report every profile, rebuilding each time (leaves the last one built)
+report-all:
+	@for profile in small barrel compressed fast; do \
+		$(MAKE) --no-print-directory clean; \
+		$(MAKE) --no-print-directory CPU_PROFILE=$$profile report; \
+	done
 
 firmware.bin: firmware.elf
 	/opt/riscv32i/bin/riscv32-unknown-elf-objcopy -O binary firmware.elf /dev/stdout > firmware.bin
 
 clean:
 	rm -f firmware.elf firmware.hex firmware.bin firmware.o firmware.map \
-	      hardware.blif hardware.log hardware.asc hardware.rpt hardware.bin
+	      hardware.blif hardware.log hardware.asc hardware.rpt hardware.bin \
+	      iocpu.elf iocpu.bin iocpu.map
 
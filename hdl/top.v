@@ -109,14 +109,57 @@ module top (
     // Disable USB
     assign USBPU = 1'b0;
 
+    ///////////////////////////////////
+    // System clock
+    ///////////////////////////////////
+    // SYS_CLK_MHZ comes from tiny_soc.mk: 16 is the board's oscillator
+    // (CLK) as it is, the others are made from it by the PLL
+`ifndef SYS_CLK_MHZ
+`define SYS_CLK_MHZ 16
+`endif
+    localparam integer SYS_CLK_HZ = `SYS_CLK_MHZ * 1000000;
+
+    // VCO = 16MHz * (DIVF + 1), 533 to 1066MHz; out = VCO / 2**DIVQ
+    localparam [6:0] PLL_DIVF = `SYS_CLK_MHZ == 24 ? 47 : `SYS_CLK_MHZ == 32 ? 63 :
+                                `SYS_CLK_MHZ == 40 ? 39 : 47;
+    localparam [2:0] PLL_DIVQ = `SYS_CLK_MHZ == 24 || `SYS_CLK_MHZ == 32 ? 5 : 4;
+
+    wire clk;
+    wire pll_locked;
+
+    generate if (SYS_CLK_HZ == 16000000) begin
+        assign clk = CLK;
+        assign pll_locked = 1'b1;
+    end else begin
+        SB_PLL40_CORE #(
+            .FEEDBACK_PATH("SIMPLE"),
+            .DIVR(4'b0000),
+            .DIVF(PLL_DIVF),
+            .DIVQ(PLL_DIVQ),
+            .FILTER_RANGE(3'b001)
+        ) pll (
+            .LOCK(pll_locked),
+            .RESETB(1'b1),
+            .BYPASS(1'b0),
+            .REFERENCECLK(CLK),
+            .PLLOUTCORE(clk)
+        );
+    end endgenerate
+
+    // the main CPU's block RAM, for picosoc and the bus monitor
+    localparam integer MEM_WORDS = 1024;   // 4KBytes (8 RAMS)
+
     ///////////////////////////////////
     // Power-on Reset
     ///////////////////////////////////
     reg [5:0] reset_cnt = 0;
     wire resetn = &reset_cnt;
 
-    always @(posedge CLK) begin
-        reset_cnt <= reset_cnt + !resetn;
+    always @(posedge clk) begin
+        if (!pll_locked)
+            reset_cnt <= 0;
+        else
+            reset_cnt <= reset_cnt + !resetn;
     end
 
     ///////////////////////////////////
@@ -154,28 +197,173 @@ module top (
     wire video_en  = (iomem_addr[31:24] == 8'h05); /* Video device mapped to 0x05xx_xxxx */
     wire sdcard_en  = (iomem_addr[31:24] == 8'h06); /* SPI SD card mapped to 0x06xx_xxxx */
     wire i2c_en    = (iomem_addr[31:24] == 8'h07); /* I2C device mapped to 0x067xx_xxxx */
+    wire math_en   = (iomem_addr[31:24] == 8'h09); /* multiply/divide/BCD unit mapped to 0x09xx_xxxx */
+    wire iocpu_en  = (iomem_addr[31:24] == 8'h0a); /* IO coprocessor RAMs and control mapped to 0x0Axx_xxxx */
+    wire irqctl_en = (iomem_addr[31:24] == 8'h0b); /* interrupt controller mapped to 0x0Bxx_xxxx */
+    wire timer_en  = (iomem_addr[31:24] == 8'h0c); /* timer mapped to 0x0Cxx_xxxx */
+    wire dma_en    = (iomem_addr[31:24] == 8'h0d); /* DMA engine registers mapped to 0x0Dxx_xxxx */
+    /* 0x0Exx_xxxx is the write buffer's barrier, answered before it gets here */
+    wire perf_en   = (iomem_addr[31:24] == 8'h0f); /* bus performance counters mapped to 0x0Fxx_xxxx */
+
+    // events for the interrupt controller, from whichever peripherals are built
+    wire       video_vblank;
+    wire [8:0] video_line;
+    wire [7:0] gpio_buttons;
+    wire       i2c_busy;
+    wire       sdcard_done;
+    wire       uart_rx_valid;
+    wire       uart_tx_empty;
+    wire       audio_capture_full;
+    wire       timer_match;
+    wire       dma_done;
+
+    // the main CPU's side of the bus
+    wire        soc_iomem_valid;
+    wire        soc_iomem_ready;
+    wire [3:0]  soc_iomem_wstrb;
+    wire [31:0] soc_iomem_addr;
+    wire [31:0] soc_iomem_wdata;
+    wire [31:0] soc_iomem_rdata;
+
+    // ... and after the posted write buffer, if there is one
+    wire        cpu_iomem_valid;
+    wire        cpu_iomem_ready;
+    wire [3:0]  cpu_iomem_wstrb;
+    wire [31:0] cpu_iomem_addr;
+    wire [31:0] cpu_iomem_wdata;
+    wire [31:0] cpu_iomem_rdata;
+
+`ifdef write_buffer
+    ///////////////////////////////////
+    // Posted writes: stores go on without waiting for slow peripherals
+    ///////////////////////////////////
+    write_buffer #(
+      .DEPTH_BITS(2)        // 4 stores
+    ) write_buffer (
+      .clk(clk),
+      .resetn(resetn),
+      .cpu_valid(soc_iomem_valid),
+      .cpu_ready(soc_iomem_ready),
+      .cpu_wstrb(soc_iomem_wstrb),
+      .cpu_addr(soc_iomem_addr),
+      .cpu_wdata(soc_iomem_wdata),
+      .cpu_rdata(soc_iomem_rdata),
+      .iomem_valid(cpu_iomem_valid),
+      .iomem_ready(cpu_iomem_ready),
+      .iomem_wstrb(cpu_iomem_wstrb),
+      .iomem_addr(cpu_iomem_addr),
+      .iomem_wdata(cpu_iomem_wdata),
+      .iomem_rdata(cpu_iomem_rdata)
+    );
+`else
+    assign cpu_iomem_valid = soc_iomem_valid;
+    assign soc_iomem_ready = cpu_iomem_ready;
+    assign cpu_iomem_wstrb = soc_iomem_wstrb;
+    assign cpu_iomem_addr = soc_iomem_addr;
+    assign cpu_iomem_wdata = soc_iomem_wdata;
+    assign soc_iomem_rdata = cpu_iomem_rdata;
+`endif
 
+    wire [31:0] iocpu_iomem_rdata;
+    wire iocpu_iomem_ready;
+
+`ifdef iocpu
+    ///////////////////////////////////
+    // IO coprocessor: a second CPU sharing the peripheral bus
+    ///////////////////////////////////
+    wire        io_iomem_valid;
+    wire        io_iomem_ready;
+    wire [3:0]  io_iomem_wstrb;
+    wire [31:0] io_iomem_addr;
+    wire [31:0] io_iomem_wdata;
+    wire [31:0] io_iomem_rdata;
+
+    iomem_arbiter iomem_arbiter (
+      .clk(clk),
+      .resetn(resetn),
+      .a_valid(cpu_iomem_valid),
+      .a_ready(cpu_iomem_ready),
+      .a_wstrb(cpu_iomem_wstrb),
+      .a_addr(cpu_iomem_addr),
+      .a_wdata(cpu_iomem_wdata),
+      .a_rdata(cpu_iomem_rdata),
+      .b_valid(io_iomem_valid),
+      .b_ready(io_iomem_ready),
+      .b_wstrb(io_iomem_wstrb),
+      .b_addr(io_iomem_addr),
+      .b_wdata(io_iomem_wdata),
+      .b_rdata(io_iomem_rdata),
+      .iomem_valid(iomem_valid),
+      .iomem_ready(iomem_ready),
+      .iomem_wstrb(iomem_wstrb),
+      .iomem_addr(iomem_addr),
+      .iomem_wdata(iomem_wdata),
+      .iomem_rdata(iomem_rdata)
+    );
+
+    iocpu #(
+      .MEM_WORDS(1024),     // 4KBytes for its program, data and stack (8 RAMS)
+      .SHARED_WORDS(256)    // 1KByte mailbox (2 RAMS)
+    ) iocpu (
+      .clk(clk),
+      .resetn(resetn),
+      .host_valid(iomem_valid && iocpu_en),
+      .host_wstrb(iomem_wstrb),
+      .host_addr(iomem_addr),
+      .host_wdata(iomem_wdata),
+      .host_ready(iocpu_iomem_ready),
+      .host_rdata(iocpu_iomem_rdata),
+      .iomem_valid(io_iomem_valid),
+      .iomem_ready(io_iomem_ready),
+      .iomem_wstrb(io_iomem_wstrb),
+      .iomem_addr(io_iomem_addr),
+      .iomem_wdata(io_iomem_wdata),
+      .iomem_rdata(io_iomem_rdata)
+    );
+`else
+    assign iomem_valid = cpu_iomem_valid;
+    assign cpu_iomem_ready = iomem_ready;
+    assign iomem_wstrb = cpu_iomem_wstrb;
+    assign iomem_addr = cpu_iomem_addr;
+    assign iomem_wdata = cpu_iomem_wdata;
+    assign cpu_iomem_rdata = iomem_rdata;
+    assign iocpu_iomem_ready = 1'b0;
+    assign iocpu_iomem_rdata = 32'h0;
+`endif
+
+
+  wire [31:0] audio_iomem_rdata;
+  wire audio_iomem_ready;
 
 `ifdef pdm_audio
     wire audio_data;
   	assign AUDIO_LEFT = audio_data;
   	assign AUDIO_RIGHT = audio_data;
-  	audio audio_peripheral(
-  		.clk(CLK),
+  	audio #(.SYS_CLK_HZ(SYS_CLK_HZ)) audio_peripheral(
+  		.clk(clk),
   		.resetn(resetn),
   		.audio_out(audio_data),
   		.iomem_valid(iomem_valid && audio_en),
   		.iomem_wstrb(iomem_wstrb),
   		.iomem_addr(iomem_addr),
   		.iomem_wdata(iomem_wdata)
+`ifdef audio_capture
+      ,
+      .iomem_ready(audio_iomem_ready),
+      .iomem_rdata(audio_iomem_rdata),
+      .capture_full(audio_capture_full)
+`endif
   );
 `endif
+`ifndef audio_capture
+  assign audio_capture_full = 1'b0;
+`endif
 
   wire oled_iomem_ready;
 
 `ifdef oled
-  video_oled oled (
-    .clk(CLK),
+  video_oled #(.SYS_CLK_HZ(SYS_CLK_HZ)) oled (
+    .clk(clk),
     .resetn(resetn),
     .iomem_valid(iomem_valid && video_en),
     .iomem_wstrb(iomem_wstrb),
@@ -196,8 +384,8 @@ module top (
 
   assign lcd_backlight = 1;
 
-  ili9341_direct lcd_peripheral(
-    .clk(CLK),
+  ili9341_direct #(.SYS_CLK_HZ(SYS_CLK_HZ)) lcd_peripheral(
+    .clk(clk),
     .resetn(resetn),
     .iomem_valid(iomem_valid && video_en),
     .iomem_wstrb(iomem_wstrb),
@@ -214,8 +402,8 @@ module top (
 `ifdef sdcard
   wire [31:0] sdcard_iomem_rdata;
 
-  sdcard sd (
-    .clk(CLK),
+  sdcard #(.SYS_CLK_HZ(SYS_CLK_HZ)) sd (
+    .clk(clk),
     .resetn(resetn),
     .iomem_valid(iomem_valid && sdcard_en),
     .iomem_wstrb(iomem_wstrb),
@@ -226,8 +414,11 @@ module top (
     .SD_MOSI(SD_MOSI),
     .SD_MISO(SD_MISO),
     .SD_SCK(SD_SCK),
-    .SD_CS(SD_CS)
+    .SD_CS(SD_CS),
+    .done(sdcard_done)
   );
+`else
+  assign sdcard_done = 1'b0;
 `endif
 
   wire sdcard_iomem_ready;
@@ -236,22 +427,24 @@ module top (
 
   assign lcd_backlight = 1;
 
-  video_vga vga_video_peripheral(
-    .clk(CLK),
+  video_vga #(.SYS_CLK_HZ(SYS_CLK_HZ)) vga_video_peripheral(
+    .clk(clk),
     .resetn(resetn),
     .iomem_valid(iomem_valid && video_en),
     .iomem_wstrb(iomem_wstrb),
     .iomem_addr(iomem_addr),
     .iomem_wdata(iomem_wdata),
     .nreset(lcd_nreset),
+    .vblank(video_vblank),
+    .line(video_line),
     .cmd_data(lcd_cmd_data),
     .write_edge(lcd_write_edge),
     .dout({lcd_D7, lcd_D6, lcd_D5, lcd_D4,
            lcd_D3, lcd_D2, lcd_D1, lcd_D0})
       );
 `elsif vga
-  video_vga vga_video_peripheral(
-    .clk(CLK),
+  video_vga #(.SYS_CLK_HZ(SYS_CLK_HZ)) vga_video_peripheral(
+    .clk(clk),
     .resetn(resetn),
     .iomem_valid(iomem_valid && video_en),
     .iomem_wstrb(iomem_wstrb),
@@ -261,8 +454,13 @@ module top (
     .vga_vsync(VGA_VSYNC),
     .vga_r(VGA_R),
     .vga_g(VGA_G),
-    .vga_b(VGA_B)
+    .vga_b(VGA_B),
+    .vblank(video_vblank),
+    .line(video_line)
  );
+`else
+  assign video_vblank = 1'b0;
+  assign video_line = 9'h0;
 `endif
 
   wire [31:0] gpio_iomem_rdata;
@@ -270,7 +468,7 @@ module top (
 
 `ifdef gpio
   gpio gpio_peripheral(
-    .clk(CLK),
+    .clk(clk),
     .resetn(resetn),
     .iomem_ready(gpio_iomem_ready),
     .iomem_rdata(gpio_iomem_rdata),
@@ -279,11 +477,13 @@ module top (
     .iomem_addr(iomem_addr),
     .iomem_wdata(iomem_wdata),
     .BUTTONS(BUTTONS),
+    .buttons(gpio_buttons),
     .led(LED)
   );
 `else
   assign gpio_iomem_ready = gpio_en;
   assign gpio_iomem_rdata = 32'h0;
+  assign gpio_buttons = 8'h0;
 `endif
 
 
@@ -295,8 +495,8 @@ wire [31:0] i2c_iomem_rdata;
 wire i2c_iomem_ready;
 
 `ifdef i2c
-  i2c i2c_peripheral(
-    .clk(CLK),
+  i2c #(.SYS_CLK_HZ(SYS_CLK_HZ)) i2c_peripheral(
+    .clk(clk),
     .resetn(resetn),
     .iomem_ready(i2c_iomem_ready),
     .iomem_rdata(i2c_iomem_rdata),
@@ -305,15 +505,201 @@ wire i2c_iomem_ready;
     .iomem_addr(iomem_addr),
     .iomem_wdata(iomem_wdata),
     .I2C_SCL(I2C_SCL),
-    .I2C_SDA(I2C_SDA)
+    .I2C_SDA(I2C_SDA),
+    .busy(i2c_busy)
   );
 `else
   assign i2c_iomem_ready = i2c_en;     /* if i2c peripheral is "disconnected", fake always available zero bytes */
   assign i2c_iomem_rdata = 32'h0;
+  assign i2c_busy = 1'b0;
+`endif
+
+///////////////////////////
+// Math Peripheral
+///////////////////////////
+
+wire [31:0] math_iomem_rdata;
+wire math_iomem_ready;
+
+`ifdef math
+  math math_peripheral(
+    .clk(clk),
+    .resetn(resetn),
+    .iomem_ready(math_iomem_ready),
+    .iomem_rdata(math_iomem_rdata),
+    .iomem_valid(iomem_valid && math_en),
+    .iomem_wstrb(iomem_wstrb),
+    .iomem_addr(iomem_addr),
+    .iomem_wdata(iomem_wdata)
+  );
+`else
+  assign math_iomem_ready = 1'b0;
+  assign math_iomem_rdata = 32'h0;
+`endif
+
+///////////////////////////
+// Timer Peripheral
+///////////////////////////
+
+wire [31:0] timer_iomem_rdata;
+wire timer_iomem_ready;
+
+`ifdef timer
+  timer #(.SYS_CLK_HZ(SYS_CLK_HZ)) timer_peripheral(
+    .clk(clk),
+    .resetn(resetn),
+    .iomem_ready(timer_iomem_ready),
+    .iomem_rdata(timer_iomem_rdata),
+    .iomem_valid(iomem_valid && timer_en),
+    .iomem_wstrb(iomem_wstrb),
+    .iomem_addr(iomem_addr),
+    .iomem_wdata(iomem_wdata),
+    .match(timer_match)
+  );
+`else
+  assign timer_iomem_ready = 1'b0;
+  assign timer_iomem_rdata = 32'h0;
+  assign timer_match = 1'b0;
+`endif
+
+///////////////////////////
+// DMA Engine
+///////////////////////////
+
+wire [31:0] dma_iomem_rdata;
+wire dma_iomem_ready;
+
+// the engine's side of picosoc's memory bus
+wire        dma_mem_valid;
+wire        dma_mem_ready;
+wire [3:0]  dma_mem_wstrb;
+wire [31:0] dma_mem_addr;
+wire [31:0] dma_mem_wdata;
+wire [31:0] dma_mem_rdata;
+
+`ifdef dma
+  dma dma_peripheral(
+    .clk(clk),
+    .resetn(resetn),
+    .iomem_ready(dma_iomem_ready),
+    .iomem_rdata(dma_iomem_rdata),
+    .iomem_valid(iomem_valid && dma_en),
+    .iomem_wstrb(iomem_wstrb),
+    .iomem_addr(iomem_addr),
+    .iomem_wdata(iomem_wdata),
+    .mem_valid(dma_mem_valid),
+    .mem_ready(dma_mem_ready),
+    .mem_wstrb(dma_mem_wstrb),
+    .mem_addr(dma_mem_addr),
+    .mem_wdata(dma_mem_wdata),
+    .mem_rdata(dma_mem_rdata),
+    .done(dma_done)
+  );
+`else
+  assign dma_iomem_ready = 1'b0;
+  assign dma_iomem_rdata = 32'h0;
+  assign dma_mem_valid = 1'b0;
+  assign dma_mem_wstrb = 4'h0;
+  assign dma_mem_addr = 32'h0;
+  assign dma_mem_wdata = 32'h0;
+  assign dma_done = 1'b0;
+`endif
+
+///////////////////////////
+// Bus Performance Counters
+///////////////////////////
+
+wire [31:0] perf_iomem_rdata;
+wire perf_iomem_ready;
+
+// the CPU's memory bus, watched by the counters
+wire        mon_valid;
+wire        mon_ready;
+wire        mon_instr;
+wire [31:0] mon_addr;
+wire        mon_irq;
+
+`ifdef perf
+  perf #(.MEM_WORDS(MEM_WORDS)) perf_peripheral(
+    .clk(clk),
+    .resetn(resetn),
+    .iomem_ready(perf_iomem_ready),
+    .iomem_rdata(perf_iomem_rdata),
+    .iomem_valid(iomem_valid && perf_en),
+    .iomem_wstrb(iomem_wstrb),
+    .iomem_addr(iomem_addr),
+    .iomem_wdata(iomem_wdata),
+    .mon_valid(mon_valid),
+    .mon_ready(mon_ready),
+    .mon_instr(mon_instr),
+    .mon_addr(mon_addr),
+    .mon_irq(mon_irq)
+  );
+`else
+  assign perf_iomem_ready = 1'b0;
+  assign perf_iomem_rdata = 32'h0;
+`endif
+
+///////////////////////////
+// Interrupt Controller
+///////////////////////////
+
+wire [31:0] irqctl_iomem_rdata;
+wire irqctl_iomem_ready;
+wire irq_5, irq_6, irq_7;
+
+`ifdef irqctl
+  irqctl irqctl_peripheral(
+    .clk(clk),
+    .resetn(resetn),
+    .iomem_ready(irqctl_iomem_ready),
+    .iomem_rdata(irqctl_iomem_rdata),
+    .iomem_valid(iomem_valid && irqctl_en),
+    .iomem_wstrb(iomem_wstrb),
+    .iomem_addr(iomem_addr),
+    .iomem_wdata(iomem_wdata),
+    .video_vblank(video_vblank),
+    .video_line(video_line),
+    .buttons(gpio_buttons),
+    .i2c_busy(i2c_busy),
+    .sdcard_done(sdcard_done),
+    .uart_rx_valid(uart_rx_valid),
+    .uart_tx_empty(uart_tx_empty),
+    .audio_capture_wrapped(audio_capture_full),
+    .timer_match(timer_match),
+    .dma_done(dma_done),
+    .irq_5(irq_5),
+    .irq_6(irq_6),
+    .irq_7(irq_7)
+  );
+`else
+  assign irqctl_iomem_ready = 1'b0;
+  assign irqctl_iomem_rdata = 32'h0;
+  assign irq_5 = 1'b0;
+  assign irq_6 = 1'b0;
+  assign irq_7 = 1'b0;
 `endif
 
 
 assign iomem_ready = i2c_en ? i2c_iomem_ready : gpio_en ? gpio_iomem_ready 
+`ifdef math
+                     : math_en ? math_iomem_ready
+`endif
+`ifdef iocpu
+                     : iocpu_en ? iocpu_iomem_ready
+`endif
+`ifdef irqctl
+                     : irqctl_en ? irqctl_iomem_ready
+`endif
+`ifdef timer
+                     : timer_en ? timer_iomem_ready
+`endif
+`ifdef dma
+                     : dma_en ? dma_iomem_ready
+`endif
+`ifdef perf
+                     : perf_en ? perf_iomem_ready
+`endif
 `ifdef oled
                      : video_en ? oled_iomem_ready
 `endif
@@ -322,34 +708,82 @@ assign iomem_ready = i2c_en ? i2c_iomem_ready : gpio_en ? gpio_iomem_ready
 `endif
 `ifdef sdcard
                      : sdcard_en ? sdcard_iomem_ready
+`endif
+`ifdef audio_capture
+                     : audio_en ? audio_iomem_ready
 `endif
                      : 1'b1;
 
 assign iomem_rdata =  i2c_iomem_ready ? i2c_iomem_rdata
                     : gpio_iomem_ready ? gpio_iomem_rdata
+`ifdef math
+                    : math_iomem_ready ? math_iomem_rdata
+`endif
+`ifdef iocpu
+                    : iocpu_iomem_ready ? iocpu_iomem_rdata
+`endif
+`ifdef irqctl
+                    : irqctl_iomem_ready ? irqctl_iomem_rdata
+`endif
+`ifdef timer
+                    : timer_iomem_ready ? timer_iomem_rdata
+`endif
+`ifdef dma
+                    : dma_iomem_ready ? dma_iomem_rdata
+`endif
+`ifdef perf
+                    : perf_iomem_ready ? perf_iomem_rdata
+`endif
 `ifdef sdcard
                     : sdcard_iomem_ready ? sdcard_iomem_rdata
+`endif
+`ifdef audio_capture
+                    : audio_iomem_ready ? audio_iomem_rdata
 `endif
                     : 32'h0;
 
 picosoc #(
+	// CPU_PROFILE in tiny_soc.mk picks these
+`ifdef cpu_barrel_shifter
+	.BARREL_SHIFTER(1),
+`else
 	.BARREL_SHIFTER(0),
+`endif
+`ifdef cpu_muldiv
+	.ENABLE_MULDIV(1),
+`else
 	.ENABLE_MULDIV(0),
+`endif
+`ifdef cpu_compressed
+	.ENABLE_COMPRESSED(1),
+`else
 	.ENABLE_COMPRESSED(0),
+`endif
 	.ENABLE_COUNTERS(0),
 	.ENABLE_IRQ_QREGS(1),
 	.ENABLE_TWO_STAGE_SHIFT(0),
+`ifdef pcpi_game
+	.ENABLE_PCPI_GAME(1),            // popcount, ffs, tile address, ... (hdl/picosoc/pcpi)
+`endif
+`ifdef dma
+	.ENABLE_DMA(1),                  // DMA engine shares the memory bus (hdl/picosoc/dma)
+`endif
+`ifdef flash_cache
+	.ENABLE_FLASH_CACHE(1),          // 1KByte read cache in front of the SPI flash (3 RAMS)
+`endif
 	.PROGADDR_RESET(32'h0005_0000), // beginning of user space in SPI flash
 	.PROGADDR_IRQ(32'h0005_0010),
-	.MEM_WORDS(1024),                // use 4KBytes of block RAM by default (8 RAMS)
+	.MEM_WORDS(MEM_WORDS),
 	.STACKADDR(1024),   /* stack addr = byte offset; stack starts at 0x400, grows downward. Data starts at 0x400+. */
 	.ENABLE_IRQ(1)
 ) soc (
-	.clk          (CLK         ),
+	.clk          (clk         ),
 	.resetn       (resetn      ),
 
 	.ser_tx       (SER_TX      ),
 	.ser_rx       (SER_RX      ),
+	.uart_rx_valid(uart_rx_valid),
+	.uart_tx_empty(uart_tx_empty),
 
 	.flash_csb    (SPI_SS   ),
 	.flash_clk    (SPI_SCK  ),
@@ -369,15 +803,28 @@ picosoc #(
 	.flash_io2_di (flash_io2_di),
 	.flash_io3_di (flash_io3_di),
 
-	.irq_5        (1'b0),
-	.irq_6        (1'b0        ),
-	.irq_7        (1'b0        ),
-
-	.iomem_valid  (iomem_valid ),
-	.iomem_ready  (iomem_ready ),
-	.iomem_wstrb  (iomem_wstrb ),
-	.iomem_addr   (iomem_addr  ),
-	.iomem_wdata  (iomem_wdata ),
-	.iomem_rdata  (iomem_rdata )
+	.irq_5        (irq_5       ),
+	.irq_6        (irq_6       ),
+	.irq_7        (irq_7       ),
+
+	.iomem_valid  (soc_iomem_valid),
+	.iomem_ready  (soc_iomem_ready),
+	.iomem_wstrb  (soc_iomem_wstrb),
+	.iomem_addr   (soc_iomem_addr ),
+	.iomem_wdata  (soc_iomem_wdata),
+	.iomem_rdata  (soc_iomem_rdata),
+
+	.dma_valid    (dma_mem_valid),
+	.dma_ready    (dma_mem_ready),
+	.dma_wstrb    (dma_mem_wstrb),
+	.dma_addr     (dma_mem_addr ),
+	.dma_wdata    (dma_mem_wdata),
+	.dma_rdata    (dma_mem_rdata),
+
+	.mon_valid    (mon_valid   ),
+	.mon_ready    (mon_ready   ),
+	.mon_instr    (mon_instr   ),
+	.mon_addr     (mon_addr    ),
+	.mon_irq      (mon_irq     )
 );
 endmodule
@@ -20,6 +20,49 @@
 #define WAVE_TRIANGLE 1
 #define WAVE_NONE     0
 
+// global filter register, 0x0400_0040 (see hdl/picosoc/audio/README.md)
+#define AUDIO_REG_FILTER 16
+
+#define FILTER_CUTOFF(c)     ((c) & 0x7f)          // 0 (~20Hz) .. 79 (~18kHz), 8 steps per octave
+#define FILTER_RESONANCE(r)  (((r) & 0xf) << 8)    // 0 (none) .. 15 (most)
+#define FILTER_ROUTE(voices) (((voices) & 0xf) << 16)
+#define FILTER_LOWPASS       (1 << 24)
+#define FILTER_BANDPASS      (1 << 25)
+#define FILTER_HIGHPASS      (1 << 26)
+
 #define reg_audio ((volatile uint32_t*)0x04000000)
 
+// capture tap (hardware built with -Daudio_capture, see hdl/picosoc/audio/README.md)
+#define reg_audio_capture        (*(volatile uint32_t*)0x04000080)
+#define reg_audio_capture_buffer ((volatile int32_t*)0x04001000)
+
+#define AUDIO_CAPTURE_SIZE       512
+
+#define AUDIO_CAPTURE_RUN        (1 << 0)   // control: start capturing
+#define AUDIO_CAPTURE_ONE_SHOT   (1 << 1)   // control: stop when the buffer is full
+#define AUDIO_CAPTURE_ON_WRITE   (1 << 2)   // control: start on the next voice register write
+#define AUDIO_CAPTURE_DECIMATE(n) (((n)-1) << 16)  // control: keep 1 in n of the 1MHz samples
+
+#define AUDIO_CAPTURE_RUNNING    (1 << 0)   // status
+#define AUDIO_CAPTURE_WRAPPED    (1 << 1)   // status
+#define AUDIO_CAPTURE_WAITING    (1 << 2)   // status
+#define AUDIO_CAPTURE_INDEX(s)   (((s) >> 16) & (AUDIO_CAPTURE_SIZE-1))
+
+// start a capture, flags are AUDIO_CAPTURE_xxx control bits
+void audio_capture_start(uint32_t flags);
+
+// print the captured samples, oldest first, over the UART
+void audio_capture_dump();
+
+// write one of a voice's registers (REG_xxx).  Host builds (HOST_AUDIO_MODEL,
+// see tools/songrender) route the write to a software model of audio.v instead.
+#ifdef HOST_AUDIO_MODEL
+void audio_model_write(uint32_t reg, uint32_t value);
+#define audio_write(voice, reg, value) audio_model_write((voice)*4+(reg), (value))
+#define audio_write_filter(value) audio_model_write(AUDIO_REG_FILTER, (value))
+#else
+#define audio_write(voice, reg, value) (reg_audio[(voice)*4+(reg)] = (value))
+#define audio_write_filter(value) (reg_audio[AUDIO_REG_FILTER] = (value))
+#endif
+
 #endif
@@ -0,0 +1,37 @@
+#include <audio/audio.h>
+#include <uart/uart.h>
+
+void audio_capture_start(uint32_t flags) {
+  reg_audio_capture = flags;
+}
+
+// Output format, one capture per dump:
+//
+//   capture <first index> <number of samples> <status>
+//   <16 samples per line, 4 hex digits each (two's complement, 14 bits)>
+//   end
+void audio_capture_dump() {
+  uint32_t status = reg_audio_capture;
+  uint32_t index = AUDIO_CAPTURE_INDEX(status);
+  uint32_t first = 0, count = index;
+
+  if (status & AUDIO_CAPTURE_WRAPPED) {
+    first = index;
+    count = AUDIO_CAPTURE_SIZE;
+  }
+
+  print("capture ");
+  print_hex(first, 4);
+  print(" ");
+  print_hex(count, 4);
+  print(" ");
+  print_hex(status, 8);
+  print("\n");
+
+  for (uint32_t i = 0; i < count; i++) {
+    print_hex(reg_audio_capture_buffer[(first + i) & (AUDIO_CAPTURE_SIZE-1)] & 0xffff, 4);
+    print((i & 15) == 15 ? "\n" : " ");
+  }
+  if (count & 15) print("\n");
+  print("end\n");
+}
@@ -0,0 +1,22 @@
+/*
+ * Boot time: firmware/start.S reads the timer's clock counter just before
+ * calling main(), after copying .ramfunc and .data and zeroing .bss.  The
+ * hardware needs -Dtimer, or boot_cycles is 0.
+ */
+#ifndef __TINYSOC_BOOT__
+#define __TINYSOC_BOOT__
+
+#include <stdint.h>
+#include <uart/uart.h>
+
+// clocks from reset to main()
+extern uint32_t boot_cycles;
+
+// print boot_cycles on the UART (set reg_uart_clkdiv first)
+static inline void boot_print(void) {
+  print("boot: ");
+  print_hex(boot_cycles, 8);
+  print(" clocks to main\n");
+}
+
+#endif
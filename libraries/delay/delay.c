@@ -1,6 +1,31 @@
 #include <delay/delay.h>
+#include <timer/timer.h>
+#include <irq/irq.h>
 
-void delay(uint32_t millis) {
-  for (uint32_t i = 0; i < (millis << 6); i++) asm volatile ("");
+void delay_us(uint32_t us) {
+  uint32_t deadline = timer_now() + us;
+
+  // the channel's interrupt only wakes waitirq: there is nothing to call
+  timer_oneshot(DELAY_TIMER_CHANNEL, us, 0);
+
+  for (;;) {
+    // with interrupts masked, one can't be handled between the check and
+    // waitirq and leave it waiting for the next; waitirq still sees it
+    uint32_t mask = maskirq(~0);
+    if ((int32_t)(timer_now() - deadline) >= 0) {
+      maskirq(mask);
+      break;
+    }
+    waitirq();
+    maskirq(mask);  // handle whatever woke us
+  }
 }
 
+void delay_ms(uint32_t ms) {
+  // timer channels reach 2^31 microseconds, so long delays are split up
+  while (ms > 1000000) {
+    delay_us(1000000000);
+    ms -= 1000000;
+  }
+  delay_us((ms << 10) - (ms << 4) - (ms << 3));  // ms * 1000, without __mulsi3
+}
@@ -3,6 +3,16 @@
 
 #include <stdint.h>
 
-void delay(uint32_t millis);
+// Delays timed by the timer peripheral (-Dtimer, libraries/timer/timer.c).
+// The CPU sleeps in picorv32's waitirq until the deadline, woken by a timer
+// channel through the interrupt controller (-Dirqctl, irqctl.c), and other
+// interrupts (music, input) are handled meanwhile.  With IRQ_5 masked the
+// delays are still right, only spent polling.  Not for interrupt handlers.
+
+// the timer channel the delays use
+#define DELAY_TIMER_CHANNEL 3
+
+void delay_us(uint32_t us);
+void delay_ms(uint32_t ms);
 
 #endif
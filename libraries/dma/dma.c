@@ -0,0 +1,48 @@
+#include "dma.h"
+#include <irqctl/irqctl.h>
+
+static dma_callback_t dma_callbacks[DMA_CHANNELS];
+
+// the IRQCTL_DMA handler: clears each channel that finished and calls it
+static void dma_dispatch(void) {
+  uint32_t done = reg_dma_done;
+  reg_dma_done = done;
+
+  for (int channel = 0; done != 0; channel++, done >>= 1)
+    if ((done & 1) && dma_callbacks[channel])
+      dma_callbacks[channel]();
+}
+
+void dma_start(int channel, const volatile void *src, volatile void *dst,
+               uint32_t words, uint32_t flags, dma_callback_t callback) {
+  dma_abort(channel);
+  dma_callbacks[channel] = callback;
+  irqctl_set_handler(IRQCTL_DMA, dma_dispatch);
+
+  reg_dma_src(channel) = (uint32_t)src;
+  reg_dma_dst(channel) = (uint32_t)dst;
+  reg_dma_count(channel) = words;
+  reg_dma_control(channel) = flags | 1;
+}
+
+void dma_wait(int channel) {
+  // each register read takes a turn on the bus from the copy, so sleep
+  // until an interrupt (the DMA event, or any other) rather than poll;
+  // masked, one can't come between the check and waitirq unseen
+  for (;;) {
+    uint32_t mask = maskirq(~0);
+    if (!dma_busy(channel)) {
+      maskirq(mask);
+      break;
+    }
+    waitirq();
+    maskirq(mask);
+  }
+}
+
+void dma_abort(int channel) {
+  dma_callbacks[channel] = 0;
+  reg_dma_control(channel) = 0;
+  while (dma_busy(channel));    // the word it was on
+  reg_dma_done = 1 << channel;
+}
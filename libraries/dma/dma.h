@@ -0,0 +1,42 @@
+#ifndef __TINYSOC_DMA__
+#define __TINYSOC_DMA__
+
+#include <stdint.h>
+
+// DMA engine (hardware built with -Ddma, see hdl/picosoc/dma/README.md).
+// Callbacks and dma_wait() also need the interrupt controller (-Dirqctl,
+// libraries/irqctl/irqctl.c); callbacks need IRQ_7 unmasked.
+#define reg_dma_busy  (*(volatile uint32_t*)0x0d000000)
+#define reg_dma_done  (*(volatile uint32_t*)0x0d000004)
+#define reg_dma_src(channel)     (*(volatile uint32_t*)(0x0d000010 + 16 * (channel)))
+#define reg_dma_dst(channel)     (*(volatile uint32_t*)(0x0d000014 + 16 * (channel)))
+#define reg_dma_count(channel)   (*(volatile uint32_t*)(0x0d000018 + 16 * (channel)))
+#define reg_dma_control(channel) (*(volatile uint32_t*)(0x0d00001c + 16 * (channel)))
+
+#define DMA_CHANNELS 2
+
+// flags for dma_start: which addresses move on a word each time; leave
+// one out for a peripheral's data register
+#define DMA_SRC_INC  2
+#define DMA_DST_INC  4
+#define DMA_COPY     (DMA_SRC_INC | DMA_DST_INC)
+
+typedef void (*dma_callback_t)(void);
+
+// copy words (1 to 65535) 32 bit words from src to dst in the background,
+// and call callback, if there is one, from the interrupt when done.  Both
+// addresses must be word aligned.
+void dma_start(int channel, const volatile void *src, volatile void *dst,
+               uint32_t words, uint32_t flags, dma_callback_t callback);
+
+static inline int dma_busy(int channel) {
+  return (reg_dma_busy >> channel) & 1;
+}
+
+// sleep until channel has finished
+void dma_wait(int channel);
+
+// stop channel after the word it is on; its callback is not called
+void dma_abort(int channel);
+
+#endif
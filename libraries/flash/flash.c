@@ -77,7 +77,7 @@ void flash_wait() {
                 if ((status & 0x01) == 0)
                         break;
 
-                delay(1);
+                delay_ms(1);
         }
 }
 
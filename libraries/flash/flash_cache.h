@@ -0,0 +1,23 @@
+#ifndef __TINYSOC_FLASH_CACHE
+#define __TINYSOC_FLASH_CACHE
+
+#include <stdint.h>
+
+// read cache in front of the memory mapped SPI flash (hardware built with
+// -Dflash_cache, see hdl/picosoc/memory/README.md)
+#define reg_flash_cache        (*(volatile uint32_t*)0x02000010)
+#define reg_flash_cache_hits   (*(volatile uint32_t*)0x02000014)
+#define reg_flash_cache_misses (*(volatile uint32_t*)0x02000018)
+
+#define FLASH_CACHE_ENABLE         (1 << 0)
+#define FLASH_CACHE_INVALIDATE     (1 << 1)   // write: drop every line, read: still busy
+#define FLASH_CACHE_CLEAR_COUNTERS (1 << 2)   // write only
+
+// drop every cached word, e.g. after writing to the flash
+#define flash_cache_invalidate() \
+  (reg_flash_cache = FLASH_CACHE_ENABLE | FLASH_CACHE_INVALIDATE)
+
+#define flash_cache_clear_counters() \
+  (reg_flash_cache = (reg_flash_cache & FLASH_CACHE_ENABLE) | FLASH_CACHE_CLEAR_COUNTERS)
+
+#endif
@@ -0,0 +1,82 @@
+#include "flash_mode.h"
+#include <irq/irq.h>
+
+#define FLASH_PROBE_WORDS 32
+
+// flash_mode_worker.S
+extern uint32_t flash_spi_worker_begin, flash_spi_worker_end;
+extern uint32_t flash_probe_worker_begin, flash_probe_worker_end;
+
+// fastest first
+static const uint32_t flash_modes[] = {
+  FLASH_MODE_QUAD_DDR | FLASH_MODE_CONT,
+  FLASH_MODE_QUAD_DDR,
+  FLASH_MODE_QUAD | FLASH_MODE_CONT,
+  FLASH_MODE_QUAD,
+  FLASH_MODE_DUAL | FLASH_MODE_CONT,
+  FLASH_MODE_DUAL,
+};
+
+void flash_spi_transfer(uint8_t *data, int len, uint8_t wrencmd)
+{
+  uint32_t func[&flash_spi_worker_end - &flash_spi_worker_begin];
+
+  uint32_t *src_ptr = &flash_spi_worker_begin;
+  uint32_t *dst_ptr = func;
+  while (src_ptr != &flash_spi_worker_end) *(dst_ptr++) = *(src_ptr++);
+
+  uint32_t irqs = maskirq(~0);
+  ((void(*)(uint8_t*, uint32_t, uint32_t))func)(data, len, wrencmd);
+  maskirq(irqs);
+}
+
+static uint8_t flash_read_status(uint8_t cmd)
+{
+  uint8_t buffer[2] = {cmd, 0};
+  flash_spi_transfer(buffer, 2, 0);
+  return buffer[1];
+}
+
+void flash_enable_quad(void)
+{
+  uint8_t sr2 = flash_read_status(0x35);
+  if (sr2 & 0x02) return;
+
+  // 0x50: write the volatile copy of the status registers, which takes
+  // effect at once instead of programming the flash
+  uint8_t buffer[3] = {0x01, flash_read_status(0x05), sr2 | 0x02};
+  flash_spi_transfer(buffer, 3, 0x50);
+}
+
+uint32_t flash_mode_probe(uint32_t mode)
+{
+  uint32_t func[&flash_probe_worker_end - &flash_probe_worker_begin];
+  uint32_t expected[FLASH_PROBE_WORDS];
+
+  uint32_t *src_ptr = &flash_probe_worker_begin;
+  uint32_t *dst_ptr = func;
+  while (src_ptr != &flash_probe_worker_end) *(dst_ptr++) = *(src_ptr++);
+
+  // any words in flash will do; use the worker's own code, read in the current mode
+  const uint32_t *reference = &flash_probe_worker_begin;
+  for (int i = 0; i < FLASH_PROBE_WORDS; i++) expected[i] = reference[i];
+
+  uint32_t irqs = maskirq(~0);
+  uint32_t ok = ((uint32_t(*)(uint32_t, const uint32_t*, uint32_t*, uint32_t))func)(
+      (reg_spictrl & ~FLASH_MODE_MASK) | mode, reference, expected, FLASH_PROBE_WORDS);
+  maskirq(irqs);
+  return ok;
+}
+
+uint32_t flash_select_mode(void)
+{
+  flash_enable_quad();
+
+  for (int i = 0; i < sizeof(flash_modes) / sizeof(flash_modes[0]); i++)
+    for (uint32_t dummy = 0; dummy < 16; dummy++)
+      if (flash_mode_probe(flash_modes[i] | FLASH_DUMMY(dummy)))
+        return flash_modes[i] | FLASH_DUMMY(dummy);
+
+  reg_spictrl = (reg_spictrl & ~FLASH_MODE_MASK) | FLASH_MODE_SINGLE | FLASH_DUMMY(8);
+  return FLASH_MODE_SINGLE;
+}
@@ -0,0 +1,43 @@
+/*
+ * SPI flash read mode selection for the memory mapped (XIP) flash
+ * controller (hdl/picosoc/memory/spimemio.v)
+ */
+#ifndef __TINYSOC_FLASH_MODE
+#define __TINYSOC_FLASH_MODE
+
+#include <stdint.h>
+
+#define reg_spictrl (*(volatile uint32_t*)0x02000000)
+
+// spimemio configuration bits (reg_spictrl[22:16])
+#define FLASH_MODE_SINGLE   0x00000000   // 03 read
+#define FLASH_MODE_DUAL     0x00400000   // BB dual IO read
+#define FLASH_MODE_QUAD     0x00200000   // EB quad IO read (needs the QE bit)
+#define FLASH_MODE_QUAD_DDR 0x00600000   // ED quad IO DDR read (needs the QE bit)
+#define FLASH_MODE_CONT     0x00100000   // continuous read: skip the command after a jump
+#define FLASH_DUMMY(n)      (((n) & 15) << 16)
+#define FLASH_MODE_MASK     0x007f0000
+
+// Send len bytes to the flash as one command (CS low for the whole transfer),
+// replacing each byte of data with the byte received.  If wrencmd is not 0 it
+// is sent as a command of its own first (e.g. 0x06, write enable), and the
+// flash is polled until it is no longer busy before returning.
+// Runs from RAM with interrupts masked, as the flash can't be read meanwhile.
+void flash_spi_transfer(uint8_t *data, int len, uint8_t wrencmd);
+
+// Set the quad enable bit (status register 2, bit 1) if it isn't already set.
+// Only the volatile copy is written, so this is needed after every power up.
+void flash_enable_quad(void);
+
+// Switch to mode (FLASH_MODE_xxx | FLASH_DUMMY(n)) and check that words read
+// from flash, sequentially and out of order, match what the current mode
+// reads.  Returns 1 and stays in the new mode if they do, otherwise goes back
+// to the current mode and returns 0.
+uint32_t flash_mode_probe(uint32_t mode);
+
+// Enable quad IO and switch to the fastest mode that passes
+// flash_mode_probe(), trying every dummy cycle count.  Returns the mode
+// selected (FLASH_MODE_SINGLE if nothing faster works).
+uint32_t flash_select_mode(void);
+
+#endif
@@ -14,7 +14,7 @@ void lcd_send_data(uint8_t d) {
 
 void lcd_reset() {
         reg_rst = 0;
-        delay(2);
+        delay_ms(2);
         reg_rst = 1;
         for(int i=0;i<3;i++) reg_xfer = 0x00;
 }
@@ -22,11 +22,11 @@ void lcd_reset() {
 void lcd_init() {
         lcd_reset();
 
-        delay(200);
+        delay_ms(200);
 
         lcd_send_cmd(ILI9341_SOFTRESET);
 
-        delay(50);
+        delay_ms(50);
 
         lcd_send_cmd(ILI9341_DISPLAYOFF);
 
@@ -58,11 +58,11 @@ void lcd_init() {
 
         lcd_send_cmd(ILI9341_SLEEPOUT);
 
-        delay(150);
+        delay_ms(150);
 
         lcd_send_cmd(ILI9341_DISPLAYON);
 
-        delay(500);
+        delay_ms(500);
 }
 
 void lcd_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
@@ -0,0 +1,19 @@
+#include "iocpu.h"
+
+// iocpu.bin, included by iocpu_image.S
+extern const uint32_t iocpu_image_begin[], iocpu_image_end[];
+
+void iocpu_start(void) {
+  iocpu_stop();
+
+  const uint32_t *src = iocpu_image_begin;
+  volatile uint32_t *dst = IOCPU_RAM;
+  while (src < iocpu_image_end)
+    *dst++ = *src++;
+
+  reg_iocpu_ctrl = 1;
+}
+
+void iocpu_stop(void) {
+  reg_iocpu_ctrl = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef __TINYSOC_IOCPU__
+#define __TINYSOC_IOCPU__
+
+#include <stdint.h>
+
+// IO coprocessor (hardware built with -Diocpu, see
+// hdl/picosoc/iocpu/README.md).  The two CPUs talk through the shared RAM;
+// lay it out as a struct both programs include, eg.
+//
+//   #define mailbox ((volatile struct mailbox_t *)IOCPU_SHARED)
+
+#ifndef IOCPU_SIDE
+// main CPU side
+#define reg_iocpu_ctrl  (*(volatile uint32_t*)0x0a200000)
+#define IOCPU_RAM       ((volatile uint32_t*)0x0a000000)
+#define IOCPU_SHARED    ((volatile uint32_t*)0x0a100000)
+
+// copy the coprocessor program (iocpu.bin, built from IOCPU_C_FILES by
+// tiny_soc.mk) into its RAM and start it; calling again restarts it
+void iocpu_start(void);
+
+// hold the coprocessor in reset
+void iocpu_stop(void);
+
+#else
+// coprocessor side (compiled with -DIOCPU_SIDE)
+#define IOCPU_SHARED    ((volatile uint32_t*)0x01000000)
+
+// clocks since the coprocessor was started (wraps every 268s at 16MHz)
+static inline uint32_t iocpu_cycles(void) {
+  uint32_t cycles;
+  asm volatile ("rdcycle %0" : "=r"(cycles));
+  return cycles;
+}
+#endif
+
+#endif
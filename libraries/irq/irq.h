@@ -0,0 +1,43 @@
+/*
+ * Interrupt vectors, dispatched by the IRQ entry code in firmware/start.S
+ */
+#ifndef __TINYSOC_IRQ__
+#define __TINYSOC_IRQ__
+
+#include <stdint.h>
+
+// picorv32 interrupt numbers (bits of the mask passed to set_irq_mask)
+#define IRQ_TIMER     0   // set_timer_counter() reached 0
+#define IRQ_EBREAK    1   // ebreak, ecall or illegal instruction
+#define IRQ_BUS_ERROR 2   // misaligned memory access
+#define IRQ_5         5   // interrupt controller: video and timer events (libraries/irqctl)
+#define IRQ_6         6   // interrupt controller: input and UART events
+#define IRQ_7         7   // interrupt controller: SD card, audio and DMA events
+
+#define IRQ_VECTORS   8   // must match start.S
+
+typedef void (*irq_vector_t)(void);
+
+// irq_vectors[n] is called for each pending interrupt n, lowest first.
+// Pending interrupts without a vector are passed to irq_handler(irqs, regs)
+// if the program has one; regs then only holds the registers the entry code
+// saves (x5-x19 and x28-x31), each at regs[n].
+extern volatile irq_vector_t irq_vectors[IRQ_VECTORS];
+
+#define irq_set_vector(irq, vector) (irq_vectors[irq] = (vector))
+
+// picorv32 custom instructions (firmware/custom_ops.S)
+
+// set the interrupt mask (1 = masked), returning the old one
+static inline uint32_t maskirq(uint32_t mask) {
+  register uint32_t a0 asm("a0") = mask;
+  asm volatile (".word 0x0605650b" : "+r"(a0));  // maskirq a0, a0
+  return a0;
+}
+
+// wait for an interrupt, masked or not
+static inline void waitirq(void) {
+  asm volatile (".word 0x0800400b");             // waitirq zero
+}
+
+#endif
@@ -0,0 +1,31 @@
+#include "irqctl.h"
+#include <ramfunc/ramfunc.h>
+
+static irq_vector_t irqctl_vectors[IRQCTL_EVENTS];
+
+// installed in irq_vectors[] for IRQ 5, 6 and 7: acknowledges every enabled
+// event and calls its handler, so the first of them to run handles the lot
+static RAMFUNC void irqctl_dispatch(void) {
+  uint32_t active = reg_irqctl_pending & reg_irqctl_enable;
+  reg_irqctl_ack = active;
+
+  for (int event = 0; active != 0; event++, active >>= 1)
+    if (active & 1)
+      irqctl_vectors[event]();
+}
+
+void irqctl_set_handler(int event, irq_vector_t handler) {
+  irqctl_vectors[event] = handler;
+
+  irq_set_vector(IRQ_5, irqctl_dispatch);
+  irq_set_vector(IRQ_6, irqctl_dispatch);
+  irq_set_vector(IRQ_7, irqctl_dispatch);
+
+  // drop anything that happened before it was enabled
+  reg_irqctl_ack = 1 << event;
+  reg_irqctl_enable_set = 1 << event;
+}
+
+void irqctl_disable(int event) {
+  reg_irqctl_enable_clear = 1 << event;
+}
@@ -0,0 +1,37 @@
+#ifndef __TINYSOC_IRQCTL__
+#define __TINYSOC_IRQCTL__
+
+#include <stdint.h>
+#include <irq/irq.h>
+
+// interrupt controller (hardware built with -Dirqctl, see
+// hdl/picosoc/irqctl/README.md)
+#define reg_irqctl_pending (*(volatile uint32_t*)0x0b000000)
+#define reg_irqctl_enable  (*(volatile uint32_t*)0x0b000004)
+#define reg_irqctl_ack     (*(volatile uint32_t*)0x0b000008)
+#define reg_irqctl_raster  (*(volatile uint32_t*)0x0b00000c)
+#define reg_irqctl_enable_set   (*(volatile uint32_t*)0x0b000010)   // write 1s to enable
+#define reg_irqctl_enable_clear (*(volatile uint32_t*)0x0b000014)   // write 1s to disable
+
+// events, and the picorv32 interrupt each one raises
+#define IRQCTL_VBLANK   0   // IRQ_5: vertical blanking starts (LCD: a frame starts)
+#define IRQCTL_RASTER   1   // IRQ_5: line reg_irqctl_raster starts
+#define IRQCTL_BUTTON   2   // IRQ_6: a button was pressed or released
+#define IRQCTL_I2C      3   // IRQ_6: an I2C transfer finished
+#define IRQCTL_UART_RX  4   // IRQ_6: the UART received a byte
+#define IRQCTL_SDCARD   5   // IRQ_7: an SD card transfer finished
+#define IRQCTL_AUDIO    6   // IRQ_7: the audio capture buffer wrapped
+#define IRQCTL_TIMER    7   // IRQ_5: a timer channel fired (libraries/timer)
+#define IRQCTL_DMA      8   // IRQ_7: a DMA channel finished (libraries/dma)
+#define IRQCTL_UART_TX  9   // IRQ_6: the UART's TX FIFO emptied (libraries/log)
+
+#define IRQCTL_EVENTS   10
+
+// call handler, from the interrupt, each time event happens, and enable
+// it.  The handler's picorv32 interrupt must be unmasked (set_irq_mask).
+void irqctl_set_handler(int event, irq_vector_t handler);
+
+// stop handling event
+void irqctl_disable(int event);
+
+#endif
@@ -0,0 +1,104 @@
+#include <stdbool.h>
+#include "log.h"
+#include <irqctl/irqctl.h>
+
+#define reg_uart_data   (*(volatile uint32_t*)0x02000008)
+#define reg_uart_status (*(volatile uint32_t*)0x0200000c)
+
+#define UART_TX_ROOM    0xff       // bytes the TX FIFO has room for
+#define UART_TX_DONE    (1 << 8)   // everything sent
+
+#define LOG_BUFFER_SIZE (1 << LOG_BUFFER_BITS)
+
+// log_head is only moved by the program, log_tail only by log_send()
+static volatile char log_buffer[LOG_BUFFER_SIZE];
+static volatile uint32_t log_head, log_tail;
+static uint32_t log_dropped;
+
+static const uint32_t powers_of_ten[] = {
+  1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+};
+
+// move what the TX FIFO has room for from the buffer into it: the
+// IRQCTL_UART_TX handler, and called with interrupts masked otherwise
+static void log_send(void) {
+  uint32_t room = reg_uart_status & UART_TX_ROOM;
+  uint32_t tail = log_tail;
+  while (room != 0 && tail != log_head) {
+    reg_uart_data = log_buffer[tail];
+    tail = (tail + 1) & (LOG_BUFFER_SIZE - 1);
+    room--;
+  }
+  log_tail = tail;
+}
+
+// start sending, if the FIFO isn't busy with it already
+static void log_kick(void) {
+  uint32_t irqs = maskirq(~0);
+  log_send();
+  maskirq(irqs);
+}
+
+static void log_put(char c) {
+  if (c == '\n')
+    log_put('\r');
+  uint32_t next = (log_head + 1) & (LOG_BUFFER_SIZE - 1);
+  if (next == log_tail) {
+    log_dropped++;
+    return;
+  }
+  log_buffer[log_head] = c;
+  log_head = next;
+}
+
+void log_init(void) {
+  irqctl_set_handler(IRQCTL_UART_TX, log_send);
+}
+
+void log_char(char c) {
+  log_put(c);
+  log_kick();
+}
+
+void log_str(const char *s) {
+  while (*s)
+    log_put(*(s++));
+  log_kick();
+}
+
+void log_hex(uint32_t value, int digits) {
+  for (int i = (digits - 1) << 2; i >= 0; i -= 4)
+    log_put("0123456789ABCDEF"[(value >> i) & 15]);
+  log_kick();
+}
+
+void log_dec(int32_t value) {
+  uint32_t u = value;
+  if (value < 0) {
+    log_put('-');
+    u = -u;
+  }
+  // each digit by repeated subtraction: at most 9 per power of ten
+  bool started = false;
+  for (int i = 0; i < 10; i++) {
+    char digit = '0';
+    while (u >= powers_of_ten[i]) {
+      u -= powers_of_ten[i];
+      digit++;
+    }
+    if (digit != '0' || started || i == 9) {
+      log_put(digit);
+      started = true;
+    }
+  }
+  log_kick();
+}
+
+void log_flush(void) {
+  while (log_tail != log_head || !(reg_uart_status & UART_TX_DONE))
+    log_kick();
+}
+
+uint32_t log_lost(void) {
+  return log_dropped;
+}
@@ -0,0 +1,80 @@
+/*
+ * Logging that doesn't hold the game up: messages go into a ring buffer in
+ * RAM, and the UART's TX FIFO empty interrupt (hdl/picosoc/irqctl,
+ * IRQCTL_UART_TX) feeds them out in the background.  Whatever doesn't fit
+ * in the buffer is dropped and counted, rather than waited for.
+ *
+ * Messages are compiled in or out by level: LOG_DEBUG(...) and friends
+ * take statements, which are dropped entirely below LOG_LEVEL:
+ *
+ *   LOG_DEBUG(log_str("y is "); log_dec(y); log_char('\n'));
+ *
+ * tiny_soc.mk sets LOG_LEVEL ("make clean upload LOG_LEVEL=DEBUG").
+ */
+#ifndef __TINYSOC_LOG__
+#define __TINYSOC_LOG__
+
+#include <stdint.h>
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) do { __VA_ARGS__; } while (0)
+#else
+#define LOG_ERROR(...) do { } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) do { __VA_ARGS__; } while (0)
+#else
+#define LOG_WARN(...) do { } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) do { __VA_ARGS__; } while (0)
+#else
+#define LOG_INFO(...) do { } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) do { __VA_ARGS__; } while (0)
+#else
+#define LOG_DEBUG(...) do { } while (0)
+#endif
+
+// ring buffer size: 2^LOG_BUFFER_BITS bytes of RAM
+#ifndef LOG_BUFFER_BITS
+#define LOG_BUFFER_BITS 8
+#endif
+
+// send from the TX FIFO interrupt.  Needs the hardware built with
+// -Dirqctl and IRQ_6 unmasked (set_irq_mask); without it the buffer is
+// only sent as far as the FIFO has room each time something is logged,
+// and by log_flush().
+void log_init(void);
+
+// add to the buffer; '\n' becomes "\r\n", as putchar() does
+void log_char(char c);
+void log_str(const char *s);
+
+// digits hex digits, most significant first
+void log_hex(uint32_t value, int digits);
+
+// signed decimal, without dividing
+void log_dec(int32_t value);
+
+// wait until everything logged has been sent
+void log_flush(void);
+
+// bytes dropped so far because the buffer was full
+uint32_t log_lost(void);
+
+#endif
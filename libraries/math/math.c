@@ -0,0 +1,59 @@
+#include <math/math.h>
+#include <irq/irq.h>
+
+// The operands and results are one set of registers, so an operation
+// is done with interrupts masked: a handler using the unit (as any *, /
+// or % does without the M extension) would otherwise replace operand a,
+// or the result, of an operation it interrupted.
+static uint32_t math_op(volatile uint32_t *start, volatile uint32_t *result,
+                        uint32_t a, uint32_t b) {
+  uint32_t irqs = maskirq(~0);
+  reg_math_a = a;
+  *start = b;
+  uint32_t r = *result;
+  maskirq(irqs);
+  return r;
+}
+
+uint32_t math_mul(uint32_t a, uint32_t b) {
+  return math_op(&reg_math_mul, &reg_math_result, a, b);
+}
+
+uint32_t math_mulhu(uint32_t a, uint32_t b) {
+  return math_op(&reg_math_mul, &reg_math_high, a, b);
+}
+
+uint32_t math_divu(uint32_t a, uint32_t b) {
+  return math_op(&reg_math_div, &reg_math_result, a, b);
+}
+
+uint32_t math_modu(uint32_t a, uint32_t b) {
+  return math_op(&reg_math_div, &reg_math_high, a, b);
+}
+
+// rounds towards zero, like C
+int32_t math_div(int32_t a, int32_t b) {
+  if (b == 0) return -1;
+  uint32_t q = math_divu(a < 0 ? -(uint32_t)a : a, b < 0 ? -(uint32_t)b : b);
+  return (a < 0) != (b < 0) ? -q : q;
+}
+
+// takes the sign of a, like C
+int32_t math_mod(int32_t a, int32_t b) {
+  uint32_t r = math_modu(a < 0 ? -(uint32_t)a : a, b < 0 ? -(uint32_t)b : b);
+  return a < 0 ? -r : r;
+}
+
+uint32_t math_bcd(uint32_t value) {
+  return math_op(&reg_math_bcd, &reg_math_result, 0, value);
+}
+
+// Without the M extension gcc calls these for *, / and % on variables;
+// without libgcc (-nostdlib) they would not link.  The calls only appear
+// after link-time optimisation has run (BUILD=release), so it must keep
+// these even though it sees nothing use them.
+__attribute__((used)) uint32_t __mulsi3(uint32_t a, uint32_t b) { return math_mul(a, b); }
+__attribute__((used)) uint32_t __udivsi3(uint32_t a, uint32_t b) { return math_divu(a, b); }
+__attribute__((used)) uint32_t __umodsi3(uint32_t a, uint32_t b) { return math_modu(a, b); }
+__attribute__((used)) int32_t __divsi3(int32_t a, int32_t b) { return math_div(a, b); }
+__attribute__((used)) int32_t __modsi3(int32_t a, int32_t b) { return math_mod(a, b); }
@@ -0,0 +1,29 @@
+#ifndef __TINYSOC_MATH__
+#define __TINYSOC_MATH__
+
+#include <stdint.h>
+
+// multiply/divide/BCD unit (hardware built with -Dmath, see
+// hdl/picosoc/math/README.md).  Each call costs a fixed 32 clocks in the
+// unit, plus the bus accesses, with interrupts masked throughout so that
+// handlers can use the unit too.  Use these rather than the registers
+// directly, unless interrupts are masked.  Only the main CPU may use the
+// unit: the IO coprocessor has no way to keep it to itself.
+#define reg_math_a      (*(volatile uint32_t*)0x09000000)
+#define reg_math_mul    (*(volatile uint32_t*)0x09000004)
+#define reg_math_div    (*(volatile uint32_t*)0x09000008)
+#define reg_math_bcd    (*(volatile uint32_t*)0x0900000c)
+#define reg_math_result (*(volatile uint32_t*)0x09000010)
+#define reg_math_high   (*(volatile uint32_t*)0x09000014)
+
+uint32_t math_mul(uint32_t a, uint32_t b);     // low word, signed or unsigned
+uint32_t math_mulhu(uint32_t a, uint32_t b);   // high word, unsigned
+uint32_t math_divu(uint32_t a, uint32_t b);
+uint32_t math_modu(uint32_t a, uint32_t b);
+int32_t math_div(int32_t a, int32_t b);
+int32_t math_mod(int32_t a, int32_t b);
+
+// value's low 8 decimal digits, 4 bits each: math_bcd(1234) == 0x1234
+uint32_t math_bcd(uint32_t value);
+
+#endif
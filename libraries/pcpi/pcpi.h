@@ -0,0 +1,50 @@
+#ifndef __TINYSOC_PCPI__
+#define __TINYSOC_PCPI__
+
+#include <stdint.h>
+
+// Game instructions of the PCPI unit (hardware built with -Dpcpi_game, see
+// hdl/picosoc/pcpi/README.md).  Without the unit they trap.  The
+// encodings are those of firmware/custom_ops.S's tinysoc_*_insn macros,
+// with rd = rs1 = a0 and rs2 = a1.
+
+#define PCPI_GAME_INLINE static inline __attribute__((always_inline))
+
+// number of set bits
+PCPI_GAME_INLINE uint32_t pcpi_popcount(uint32_t value) {
+  register uint32_t a0 asm("a0") = value;
+  asm volatile (".word 0x0005052b" : "+r"(a0));   // popcount a0, a0
+  return a0;
+}
+
+// 1 + the index of the lowest set bit, 0 if none (like ffs())
+PCPI_GAME_INLINE uint32_t pcpi_ffs(uint32_t value) {
+  register uint32_t a0 asm("a0") = value;
+  asm volatile (".word 0x0205052b" : "+r"(a0));   // ffs a0, a0
+  return a0;
+}
+
+// address of tile (x, y) in the video tile memory, as vid_set_tile() uses
+PCPI_GAME_INLINE volatile uint32_t *pcpi_tile_addr(uint32_t x, uint32_t y) {
+  register uint32_t a0 asm("a0") = x;
+  register uint32_t a1 asm("a1") = y;
+  asm volatile (".word 0x04b5052b" : "+r"(a0) : "r"(a1));   // tileaddr a0, a0, a1
+  return (volatile uint32_t *)a0;
+}
+
+// a + b, no more than 0xffff (for uint16_t scores)
+PCPI_GAME_INLINE uint32_t pcpi_addsat16(uint32_t a, uint32_t b) {
+  register uint32_t a0 asm("a0") = a;
+  register uint32_t a1 asm("a1") = b;
+  asm volatile (".word 0x06b5052b" : "+r"(a0) : "r"(a1));   // addsat16 a0, a0, a1
+  return a0;
+}
+
+// the low 16 bits in reverse order: a sprite row mirrored
+PCPI_GAME_INLINE uint32_t pcpi_brev16(uint32_t value) {
+  register uint32_t a0 asm("a0") = value;
+  asm volatile (".word 0x0805052b" : "+r"(a0));   // brev16 a0, a0
+  return a0;
+}
+
+#endif
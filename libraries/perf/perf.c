@@ -0,0 +1,65 @@
+#include "perf.h"
+#include <uart/uart.h>
+
+// the iomem slots worth a column (top.v)
+static const struct {
+  const char *name;
+  int slot;
+} perf_slots[] = {
+  { " gpio ", 0x03 },
+  { " audio ", 0x04 },
+  { " video ", 0x05 },
+  { " sd ", 0x06 },
+  { " i2c ", 0x07 },
+  { " math ", 0x09 },
+  { " iocpu ", 0x0a },
+  { " timer ", 0x0c },
+};
+
+// no divide instruction, and no libgcc
+static uint32_t udiv(uint32_t n, uint32_t d) {
+  uint32_t q = 0, r = 0;
+  for (int i = 31; i >= 0; i--) {
+    r = (r << 1) | ((n >> i) & 1);
+    if (r >= d) {
+      r -= d;
+      q |= 1 << i;
+    }
+  }
+  return q;
+}
+
+// count as a percentage of total, as two digits ("99" for 100%)
+static void print_percent(uint32_t count, uint32_t total) {
+  // keep count * 100 inside 32 bits
+  while (total >= 1 << 24) {
+    count >>= 1;
+    total >>= 1;
+  }
+  uint32_t percent = total ? udiv((count << 6) + (count << 5) + (count << 2), total) : 0;
+  if (percent > 99) percent = 99;
+  uint32_t tens = udiv(percent, 10);
+  putchar('0' + tens);
+  putchar('0' + percent - (tens << 3) - (tens << 1));
+  putchar('%');
+}
+
+void perf_report(void) {
+  reg_perf_control = PERF_STOP;
+  uint32_t cycles = reg_perf_cycles;
+
+  print("clocks "); print_hex(cycles, 8);
+  print(" fetches "); print_hex(reg_perf_fetches, 8);
+  print(" irqs "); print_hex(reg_perf_irqs, 4);
+  print(" in irq "); print_percent(reg_perf_irq_cycles, cycles);
+  print(" | stalls: flash "); print_percent(reg_perf_flash_stall, cycles);
+  print(" ram "); print_percent(reg_perf_ram_stall, cycles);
+  print(" uart/spi "); print_percent(reg_perf_soc_stall, cycles);
+  for (int i = 0; i < sizeof(perf_slots) / sizeof(perf_slots[0]); i++) {
+    print(perf_slots[i].name);
+    print_percent(reg_perf_iomem_stall(perf_slots[i].slot), cycles);
+  }
+  print("\n");
+
+  perf_reset();
+}
@@ -0,0 +1,32 @@
+#ifndef __TINYSOC_PERF__
+#define __TINYSOC_PERF__
+
+#include <stdint.h>
+
+// bus performance counters (hardware built with -Dperf, see
+// hdl/picosoc/perf/README.md)
+#define reg_perf_control     (*(volatile uint32_t*)0x0f000000)
+#define reg_perf_cycles      (*(volatile uint32_t*)0x0f000004)
+#define reg_perf_fetches     (*(volatile uint32_t*)0x0f000008)
+#define reg_perf_irqs        (*(volatile uint32_t*)0x0f00000c)
+#define reg_perf_irq_cycles  (*(volatile uint32_t*)0x0f000010)
+#define reg_perf_flash_stall (*(volatile uint32_t*)0x0f000014)
+#define reg_perf_ram_stall   (*(volatile uint32_t*)0x0f000018)
+#define reg_perf_soc_stall   (*(volatile uint32_t*)0x0f00001c)
+#define reg_perf_iomem_stall(slot) (*(volatile uint32_t*)(0x0f000040 + 4 * (slot)))
+
+#define PERF_CLEAR 1
+#define PERF_STOP  2
+
+// clear the counters and start counting
+static inline void perf_reset(void) {
+  reg_perf_control = PERF_CLEAR;
+}
+
+// print where the clocks went since perf_reset() on the UART, as one line
+// of percentages of the clocks counted, then clear the counters.  The
+// counters are stopped while it prints, so call it at the end of the
+// stretch being measured, such as a frame.
+void perf_report(void);
+
+#endif
@@ -0,0 +1,56 @@
+#include "ramcheck.h"
+#include <uart/uart.h>
+
+#define reg_uart_data (*(volatile uint32_t*)0x02000008)
+
+extern uint32_t _heap_start;   // sections.lds: the end of .bss
+
+// bytes below top that no longer hold the paint, scanning up from bottom
+static uint32_t used_below(uint32_t bottom, uint32_t top) {
+  volatile uint32_t *p = (volatile uint32_t *)bottom;
+  while ((uint32_t)p < top && *p == RAM_PAINT) p++;
+  return top - (uint32_t)p;
+}
+
+// bytes above bottom that no longer hold the paint, scanning down from top
+static uint32_t used_above(uint32_t bottom, uint32_t top) {
+  volatile uint32_t *p = (volatile uint32_t *)top;
+  while ((uint32_t)p > bottom && p[-1] == RAM_PAINT) p--;
+  return (uint32_t)p - bottom;
+}
+
+void ramcheck_usage(struct ram_usage *usage) {
+  uint32_t heap_start = (uint32_t)&_heap_start;
+
+  usage->main_stack = used_below(RAM_MAIN_STACK, RAM_DATA);
+  usage->irq_stack = used_below(RAM_IRQ_STACK, RAM_MAIN_STACK);
+  usage->data = heap_start - RAM_DATA;
+  usage->heap = used_above(heap_start, RAM_END);
+}
+
+static void print_used(const char *name, uint32_t used, uint32_t size) {
+  print(name);
+  print_hex(used, 3);
+  print("/");
+  print_hex(size, 3);
+}
+
+void ramcheck_print(void) {
+  struct ram_usage usage;
+  ramcheck_usage(&usage);
+
+  print_used("RAM: stack ", usage.main_stack, RAM_DATA - RAM_MAIN_STACK);
+  print_used(" irq stack ", usage.irq_stack, RAM_MAIN_STACK - RAM_IRQ_STACK);
+  print_used(" data+heap ", usage.data + usage.heap, RAM_END - RAM_DATA);
+  print("\n");
+
+  if (usage.main_stack == RAM_DATA - RAM_MAIN_STACK)
+    print("RAM: the main stack is full, and has probably run into the IRQ stack\n");
+  if (usage.irq_stack == RAM_MAIN_STACK - RAM_IRQ_STACK)
+    print("RAM: the IRQ stack is full, and has probably run into the saved registers\n");
+}
+
+void ramcheck_poll(void) {
+  if (reg_uart_data == 'm')
+    ramcheck_print();
+}
@@ -0,0 +1,38 @@
+/*
+ * Stack and RAM high-water marks.  firmware/start.S paints the stack and
+ * the RAM above .bss with RAM_PAINT at boot; whatever no longer holds it
+ * has been used since.
+ */
+#ifndef __TINYSOC_RAMCHECK__
+#define __TINYSOC_RAMCHECK__
+
+#include <stdint.h>
+
+#define RAM_PAINT 0xa5a5a5a5   // must match start.S
+
+// the RAM map (firmware/sections.lds and the IRQ entry in start.S)
+#define RAM_IRQ_REGS    0x000  // registers saved by the IRQ entry
+#define RAM_IRQ_STACK   0x080  // bottom of the IRQ handlers' stack
+#define RAM_MAIN_STACK  0x180  // bottom of the main stack, top of the IRQ stack
+#define RAM_DATA        0x400  // .ramfunc, .data and .bss, then free RAM
+#define RAM_END         0x1000
+
+// bytes used, at most, since boot
+struct ram_usage {
+  uint32_t main_stack;  // of RAM_DATA - RAM_MAIN_STACK (640)
+  uint32_t irq_stack;   // of RAM_MAIN_STACK - RAM_IRQ_STACK (256)
+  uint32_t data;        // .ramfunc, .data and .bss, fixed by the link
+  uint32_t heap;        // RAM above .bss written to, of RAM_END - RAM_DATA - data
+};
+
+void ramcheck_usage(struct ram_usage *usage);
+
+// print the high-water marks on the UART, and warn about a stack that has
+// used all of its space, and so probably more
+void ramcheck_print(void);
+
+// call from the main loop: prints the high-water marks when an 'm' comes
+// in on the UART.  Other characters are read and dropped.
+void ramcheck_poll(void);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef __TINYSOC_RAMFUNC__
+#define __TINYSOC_RAMFUNC__
+
+// Put a function in the .ramfunc section: it is copied from flash to RAM by
+// start.S and runs from there, without waiting on the SPI flash for each
+// instruction.  RAM is only 3K (shared with .data, see firmware/sections.lds),
+// so keep it to the interrupt handler and small inner loops.
+#define RAMFUNC __attribute__((section(".ramfunc"), noinline))
+
+#endif
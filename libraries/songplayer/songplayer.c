@@ -37,6 +37,21 @@ const uint32_t note_to_freq[] = {
 };
 
 
+// update the global filter register, if it changed
+void set_filter(uint32_t filter) {
+  if (filter != globalctrl.filter) {
+    globalctrl.filter = filter;
+    audio_write_filter(filter);
+  }
+}
+
+void sweep_filter_cutoff(int8_t delta) {
+  int32_t cutoff = (globalctrl.filter & 0x7f) + delta;
+  if (cutoff < 0) cutoff = 0;
+  if (cutoff > 0x7f) cutoff = 0x7f;
+  set_filter((globalctrl.filter & ~0x7f) | FILTER_CUTOFF(cutoff));
+}
+
 void songplayer_init(const struct song_t* song) {
   // reset song player to initial position
   globalctrl.song_pos = 0;
@@ -47,6 +62,8 @@ void songplayer_init(const struct song_t* song) {
   globalctrl.tick_div_count = globalctrl.ticks_per_div;
   globalctrl.active = 1;
   player_song = song;
+  globalctrl.filter = 0;
+  audio_write_filter(0);
   for (int chan = 0; chan < 3; chan++) {
     channelctrl[chan].note.raw = 0;
     channelctrl[chan].note_on_time = 0;
@@ -65,6 +82,7 @@ void songplayer_start(int pos) {
 }
 
 void songplayer_trigger_effect(uint32_t bar_num) {
+  if (bar_num >= (uint32_t)player_song->num_bars) return;
   globalctrl.sound_fx_bar = bar_num;
   globalctrl.sound_fx_row = 0;
 }
@@ -75,20 +93,20 @@ void handle_percussion_div(int chan, int instrument) {
   switch(instrument) {
     case 1: // kick drum
       // kick drums have 1/50th sec noise followed by fast ramp down 50% pulse
-      reg_audio[chan*4+REG_FREQ]=note_to_freq[90];
-      reg_audio[chan*4+REG_WAVESELECT]=0x00080000;  /* enable, noise, fast attack/decay, full sustain volume */
+      audio_write(chan, REG_FREQ, note_to_freq[90]);
+      audio_write(chan, REG_WAVESELECT, 0x00080000);  /* enable, noise, fast attack/decay, full sustain volume */
       break;
     case 2: // hi-hat (closed)
-      reg_audio[chan*4+REG_FREQ]=note_to_freq[100];
-      reg_audio[chan*4+REG_WAVESELECT]=0x00080000;
+      audio_write(chan, REG_FREQ, note_to_freq[100]);
+      audio_write(chan, REG_WAVESELECT, 0x00080000);
       break;
     case 3: // hi-hat (open)
-      reg_audio[chan*4+REG_FREQ]=note_to_freq[100];
-      reg_audio[chan*4+REG_WAVESELECT]=0x00080000;  /* same as kick drum; noise enabled */
+      audio_write(chan, REG_FREQ, note_to_freq[100]);
+      audio_write(chan, REG_WAVESELECT, 0x00080000);  /* same as kick drum; noise enabled */
       break;
     case 4: // snare
-      reg_audio[chan*4+REG_FREQ]=note_to_freq[50];
-      reg_audio[chan*4+REG_WAVESELECT]=0x00090000;  /* combo triangle + noise (?!?!?) */
+      audio_write(chan, REG_FREQ, note_to_freq[50]);
+      audio_write(chan, REG_WAVESELECT, 0x00090000);  /* combo triangle + noise (?!?!?) */
       break;
     default:
       break;
@@ -101,18 +119,25 @@ void handle_effect_div(int chan, struct songnote_expanded_t *incoming_note) {
     case 0x01: /* slide up */
         note->new_note = note->new_note + note->effect_parameter;
         if (!incoming_note->new_note) {
-        reg_audio[chan*4+REG_FREQ] = note_to_freq[note->new_note];
+        audio_write(chan, REG_FREQ, note_to_freq[note->new_note]);
       }
       break;
     case 0x02: /* slide down */
       if (!incoming_note->new_note) {
         note->new_note = note->new_note - note->effect_parameter;
-        reg_audio[chan*4+REG_FREQ] = note_to_freq[note->new_note];
+        audio_write(chan, REG_FREQ, note_to_freq[note->new_note]);
       }
       break;
     case 0x0c: /* set volume */
       channelctrl[chan].volume = channelctrl[chan].note.note.effect_parameter;
-      reg_audio[chan*4+REG_VOLUME] = channelctrl[chan].volume;
+      audio_write(chan, REG_VOLUME, channelctrl[chan].volume);
+      break;
+    case 0x08: /* set filter cutoff */
+      set_filter((globalctrl.filter & ~0x7f) | FILTER_CUTOFF(note->effect_parameter));
+      break;
+    case 0x09: /* set filter mode (high nibble) and resonance (low nibble) */
+      set_filter((globalctrl.filter & ~(FILTER_RESONANCE(0xf) | FILTER_LOWPASS | FILTER_BANDPASS | FILTER_HIGHPASS))
+                 | FILTER_RESONANCE(note->effect_parameter) | (((note->effect_parameter >> 4) & 7) << 24));
       break;
     case 0x0b: /* position jump - jump to new pattern */
       globalctrl.next_pos_override = note->effect_parameter;
@@ -124,15 +149,18 @@ void handle_effect_tick(int chan) {
   switch(note->effect) {
     case 0x01: /* slide up */
       note->new_note = note->new_note + note->effect_parameter;
-      reg_audio[chan*4+REG_FREQ] = note_to_freq[note->new_note];
+      audio_write(chan, REG_FREQ, note_to_freq[note->new_note]);
       break;
     case 0x02: /* slide down */
       note->new_note = note->new_note - note->effect_parameter;
-      reg_audio[chan*4+REG_FREQ] = note_to_freq[note->new_note];
+      audio_write(chan, REG_FREQ, note_to_freq[note->new_note]);
       break;
     case 0x0c: /* set volume */
       channelctrl[chan].volume = channelctrl[chan].note.note.effect_parameter;
-      reg_audio[chan*4+REG_VOLUME] = channelctrl[chan].volume;
+      audio_write(chan, REG_VOLUME, channelctrl[chan].volume);
+      break;
+    case 0x0a: /* filter sweep */
+      sweep_filter_cutoff((int8_t)note->effect_parameter);
       break;
     default: break;
   }
@@ -152,20 +180,22 @@ void play_note_on_channel(int chan, struct songnote_expanded_t note) {
     channelctrl[chan].note.note.instrument = note.instrument;
 
     // set channel parameters based on instrument
+    uint32_t route = globalctrl.filter & ~FILTER_ROUTE(1 << chan);
     if (note.instrument >= FIRST_USER_INSTRUMENT) {
       struct song_instrument_t instrument = player_song->instruments[note.instrument];
-      reg_audio[chan*4+REG_WAVESELECT]=
-              (0x08<<24) /* enable voice */
-              +(instrument.waveform_select<<16);
-      reg_audio[chan*4+REG_PULSEWIDTH]=instrument.pulsewidth;
+      audio_write(chan, REG_WAVESELECT, (0x08<<24) /* enable voice */
+              +(instrument.waveform_select<<16));
+      audio_write(chan, REG_PULSEWIDTH, instrument.pulsewidth);
+      if (instrument.filter_enable) route |= FILTER_ROUTE(1 << chan);
     }
+    set_filter(route);
   }
   // handle new note
   if (note.new_note != 0) {
     channelctrl[chan].note_on_time = 0;
 
     // set frequency of note
-    reg_audio[chan*4+REG_FREQ] = note_to_freq[note.new_note];
+    audio_write(chan, REG_FREQ, note_to_freq[note.new_note]);
 
     handle_percussion_div(chan, channelctrl[chan].note.note.instrument);
 
@@ -175,7 +205,7 @@ void play_note_on_channel(int chan, struct songnote_expanded_t note) {
     } else {
       channelctrl[chan].volume = instrument.default_volume;
     }
-    reg_audio[chan*4+REG_VOLUME] = channelctrl[chan].volume;
+    audio_write(chan, REG_VOLUME, channelctrl[chan].volume);
 
   }
   // handle effects
@@ -185,24 +215,65 @@ void play_note_on_channel(int chan, struct songnote_expanded_t note) {
 
 
 
-  void divhandler() {
+// a bar of nothing but empty rows, played in place of a missing one
+static const uint8_t empty_bar[] = { SONG_SKIP(SONG_MAX_SKIP) };
 
-        int song_pattern = player_song->pattern_map[globalctrl.song_pos];
+// point a channel at the first row of a packed bar
+void seek_bar(int chan, uint32_t bar_num) {
+  if (bar_num < (uint32_t)player_song->num_bars)
+    channelctrl[chan].row_ptr = player_song->bars[bar_num];
+  else
+    channelctrl[chan].row_ptr = empty_bar;
+  channelctrl[chan].skip_rows = 0;
+}
+
+// decode the next row of the channel's current bar
+struct songnote_expanded_t read_row(int chan) {
+  struct channelctrl_t *ctrl = &channelctrl[chan];
+  union songnote_t row = { .raw = 0 };
+
+  if (ctrl->skip_rows) {
+    ctrl->skip_rows--;
+    return row.note;
+  }
+
+  uint8_t fields = *ctrl->row_ptr++;
+  if (!(fields & SONG_ROW_NOTE)) {
+    ctrl->skip_rows = fields;  /* this row, plus "fields" more empty ones */
+    return row.note;
+  }
+
+  if (fields & SONG_FIELD_INSTRUMENT) row.note.instrument = *ctrl->row_ptr++;
+  if (fields & SONG_FIELD_NOTE) row.note.new_note = *ctrl->row_ptr++;
+  if (fields & SONG_FIELD_VOLUME) row.note.volume = *ctrl->row_ptr++;
+  if (fields & SONG_FIELD_EFFECT) {
+    row.note.effect = *ctrl->row_ptr++;
+    row.note.effect_parameter = *ctrl->row_ptr++;
+  }
+  return row.note;
+}
+
+  void divhandler() {
 
         // read in new note data
         if (globalctrl.active) {
+          if (globalctrl.song_row == 0) {
+            const struct song_pattern_t *pattern = &player_song->patterns[player_song->pattern_map[globalctrl.song_pos]];
+            for (int chan = 0; chan < 3; chan++) {
+              seek_bar(chan, pattern->bar[chan]);
+            }
+          }
           for (int chan = 0; chan < 3; chan++) {
-            int current_bar_num = player_song->patterns[song_pattern].bar[chan];
-            struct songnote_expanded_t note = player_song->bars[current_bar_num].notes[globalctrl.song_row].note;
-
-            play_note_on_channel(chan, note);
+            play_note_on_channel(chan, read_row(chan));
           }
 
         }
         // deal with "sound fx" channel
         if (globalctrl.sound_fx_row < 16) {
-          struct songnote_expanded_t note = player_song->bars[globalctrl.sound_fx_bar].notes[globalctrl.sound_fx_row].note;
-          play_note_on_channel(3, note);
+          if (globalctrl.sound_fx_row == 0) {
+            seek_bar(3, globalctrl.sound_fx_bar);
+          }
+          play_note_on_channel(3, read_row(3));
           globalctrl.sound_fx_row++;
         }
   }
@@ -211,12 +282,12 @@ void play_note_on_channel(int chan, struct songnote_expanded_t note) {
   void handle_percussion_tick(int chan, int instrument) {
     switch (instrument) {
       case 1: // kick drum
-        reg_audio[chan*4+REG_PULSEWIDTH]=2048;
+        audio_write(chan, REG_PULSEWIDTH, 2048);
         int kick_drum_note = 40-(channelctrl[chan].note_on_time << 2);
         if (kick_drum_note <= 27)
           kick_drum_note = 26;
-        reg_audio[chan*4+REG_FREQ]=note_to_freq[kick_drum_note];
-        reg_audio[chan*4+REG_WAVESELECT]=0x08040000;
+        audio_write(chan, REG_FREQ, note_to_freq[kick_drum_note]);
+        audio_write(chan, REG_WAVESELECT, 0x08040000);
     }
   }
 
@@ -235,7 +306,7 @@ void play_note_on_channel(int chan, struct songnote_expanded_t note) {
         channelctrl[chan].volume = instrument.envelope->points[env_point];
       }
 
-      reg_audio[chan*4+REG_VOLUME] = channelctrl[chan].volume;
+      audio_write(chan, REG_VOLUME, channelctrl[chan].volume);
 
       handle_percussion_tick(chan, channelctrl[chan].note.note.instrument);
       handle_effect_tick(chan);
@@ -261,8 +332,11 @@ void songplayer_tick() {
     }
 
     if (globalctrl.next_pos_override != -1) {
-      globalctrl.song_pos = globalctrl.song_pos;
+      // a jump past the end of the song restarts it
+      globalctrl.song_pos = globalctrl.next_pos_override < player_song->song_length ?
+                            globalctrl.next_pos_override : 0;
       globalctrl.song_row = 0;
+      globalctrl.next_pos_override = -1;
     }
 
     divhandler();
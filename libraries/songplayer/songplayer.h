@@ -21,6 +21,7 @@ struct song_instrument_t {
   int32_t default_volume: 8;
   int32_t volume_rampdown_rate: 8;
   int32_t envelope_enable: 1;
+  int32_t filter_enable: 1;  /* route the voice through the global filter */
   const struct envelope_t *envelope;
   //uint32_t tremolo_depth;
   //uint32_t tremolo_speed;
@@ -37,6 +38,7 @@ struct globalctrl_t {
   int32_t tick_div_count;
   int32_t sound_fx_bar;
   int32_t sound_fx_row;
+  uint32_t filter;  /* last value written to the audio filter register */
 };
 
 struct songnote_expanded_t {
@@ -65,15 +67,58 @@ struct channelctrl_t {
   union songnote_t note;
   int32_t note_on_time;
   int8_t volume;
+
+  const uint8_t *row_ptr;  /* read position within the current (packed) bar */
+  uint8_t skip_rows;       /* empty rows left before the next byte is read */
 };
 
 
-struct song_bar_t {
-  union songnote_t notes[16];
-};
+// Packed bar format
+// -----------------
+// Each bar is a variable length byte stream holding rows_per_bar rows.  A
+// row is either:
+//
+//   0x00-0x7f          : a run of (value+1) empty rows
+//   0x80 | field bits  : a note row, followed by one byte for each field bit
+//                        that is set, in this order:
+//                          SONG_FIELD_INSTRUMENT -> instrument
+//                          SONG_FIELD_NOTE       -> note
+//                          SONG_FIELD_VOLUME     -> volume
+//                          SONG_FIELD_EFFECT     -> effect, effect parameter
+//
+// Fields which are not present read as zero, exactly like the unused fields
+// of the old fixed-size songnote_t rows.  Bars are built with the SONG_xxx
+// macros below, eg.
+//
+//   static const uint8_t bar_bass[] = {
+//     SONG_NOTE(48, 5), SONG_SKIP(5), SONG_NOTE(55, 5), SONG_SKIP(9)
+//   };
+
+#define SONG_ROW_NOTE         0x80
+#define SONG_FIELD_INSTRUMENT 0x01
+#define SONG_FIELD_NOTE       0x02
+#define SONG_FIELD_VOLUME     0x04
+#define SONG_FIELD_EFFECT     0x08
+
+#define SONG_MAX_SKIP         128
+
+// n empty rows (1..128)
+#define SONG_SKIP(n) ((n)-1)
+
+// new note n, played with instrument i
+#define SONG_NOTE(n, i) \
+  (SONG_ROW_NOTE | SONG_FIELD_INSTRUMENT | SONG_FIELD_NOTE), (i), (n)
+
+// new note n, played with instrument i and effect e (parameter p)
+#define SONG_NOTE_FX(n, i, e, p) \
+  (SONG_ROW_NOTE | SONG_FIELD_INSTRUMENT | SONG_FIELD_NOTE | SONG_FIELD_EFFECT), (i), (n), (e), (p)
+
+// effect e (parameter p) applied to whatever is already playing
+#define SONG_FX(e, p) \
+  (SONG_ROW_NOTE | SONG_FIELD_EFFECT), (e), (p)
 
 struct song_pattern_t {
-  uint32_t bar[4];
+  uint8_t bar[4];
 };
 
 struct song_t {
@@ -81,10 +126,11 @@ struct song_t {
   int32_t song_length;
   int32_t ticks_per_div;
 
-  struct song_instrument_t instruments[16];
-  int32_t pattern_map[256];
-  struct song_bar_t bars[256];
-  struct song_pattern_t patterns[256];
+  const struct song_instrument_t *instruments;
+  const uint8_t *pattern_map;             /* song_length entries */
+  const struct song_pattern_t *patterns;
+  const uint8_t * const *bars;            /* packed bars, see above */
+  int32_t num_bars;                       /* entries in bars */
 };
 
 
@@ -105,9 +151,17 @@ struct song_t {
 // - slide + octave arpeggio
 // - key-on / key-off
 // - vol slide
-// - filter on/off for current channel
-// - global filter controls
 // - set ticks per div
+//
+// implemented effects
+// - 0x1 slide up (semitones per tick)
+// - 0x2 slide down (semitones per tick)
+// - 0x8 set filter cutoff (0..127)
+// - 0x9 set filter mode (high nibble: 1=LP 2=BP 4=HP) and resonance (low nibble)
+// - 0xa filter sweep (signed cutoff change per tick)
+// - 0xb position jump
+// - 0xc set volume
+// (channels are routed through the filter by their instrument's filter_enable)
 
 // call to load a new song into memory
 void songplayer_init(const struct song_t *song);
@@ -122,6 +176,7 @@ void songplayer_stop();
 void songplayer_tick();
 
 // call this to trigger a "sound effect" from the given song bar (this is played on channel 4).
+// bars past the end of the song are ignored.
 void songplayer_trigger_effect(uint32_t bar_num);
 
 #endif
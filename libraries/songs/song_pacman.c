@@ -0,0 +1,180 @@
+
+#include <songplayer/songplayer.h>
+#include <audio/audio.h>
+
+static const struct envelope_t envelope0 = {
+  .num_points = 16,
+  .points = {
+    0x00, 0xff, 0xff, 0x80, 0x20, 0x10, 0x08, 0x04,
+    0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  }
+};
+
+static const struct envelope_t envelope1 = {
+  .num_points = 16,
+  .points = {
+    0x10, 0xb0, 0xb4, 0xa0, 0x80, 0x60, 0x40, 0x30,
+    0x20, 0x10, 0x08, 0x04, 0x03, 0x02, 0x01, 0x00
+  }
+};
+
+static const struct envelope_t envelope2 = {
+  .num_points = 16,
+  .points = {
+    0x80, 0x60, 0x40, 0x20, 0x10, 0x08, 0x02, 0x02,
+    0x1, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  }
+};
+
+static const struct envelope_t envelope3 = {
+  .num_points = 16,
+  .points = {
+    0xff, 0xff, 0xc0, 0x80, 0x40, 0x20, 0x10, 0x00,
+    0x0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  }
+};
+
+// notes
+// octave   C  C#   D  D#   E   F   F#   G   G#    A   A#   B
+//     -1   1   2   3   4   5   6    7   8    9   10   11  12
+//      0  13  14  15  16  17  18   19  20   21   22   23  24
+//      1  25  26  27  28  29  30   31  32   33   34   35  36
+//      2  37  38  39  40  41  42   43  44   45   46   47  48
+
+//      3  49  50  51  52  53  54   55  56   57   58   59  60
+//      4  61  62  63  64  65  66   67  68   69   70   71  72
+
+//      5  73  74  75  76  77  78   79  80   81   82   83  84
+//      6  85  86  87  88  89  90   91  92   93   94   95  96
+//      7  97  98  99  100
+
+static const struct song_instrument_t instruments[] = {
+  {.waveform_select = WAVE_NONE, .envelope = &envelope1, .envelope_enable=1, .pulsewidth = 2048},  // 0 = no instrument
+  {.waveform_select = WAVE_NONE, .envelope = &envelope0, .envelope_enable=1, .pulsewidth = 2048},  // 1 = kick drum
+  {.waveform_select = WAVE_NONE, .envelope = &envelope2, .envelope_enable=1, .pulsewidth = 2048},  // 2 = closed hihat
+  {.waveform_select = WAVE_NONE, .envelope = &envelope2, .envelope_enable=1, .pulsewidth = 2048},  // 3 = open hihat
+  {.waveform_select = WAVE_NONE, .envelope = &envelope3, .envelope_enable=1, .pulsewidth = 2048},  // 4 = snare
+
+  // first user defined instrument here:
+  {.waveform_select = WAVE_SAWTOOTH|WAVE_TRIANGLE, .envelope = &envelope1, .envelope_enable=1, .pulsewidth = 400},  // 5 = bassline
+  {.waveform_select = WAVE_SAWTOOTH|WAVE_TRIANGLE, .envelope = &envelope1, .envelope_enable=0, .default_volume=255, .pulsewidth = 400},  // 6 is used for pacman death sound effect
+  {.waveform_select = WAVE_TRIANGLE, .envelope = &envelope1, .envelope_enable=0, .default_volume=255,.pulsewidth = 400},  // 7 is used for eat-pill effect
+  {.waveform_select = WAVE_SAWTOOTH, .envelope = &envelope1, .envelope_enable=0, .default_volume=128,.pulsewidth = 2048}  // 8 is used for waka-waka noise
+};
+
+// bar 0 - silence
+static const uint8_t bar0[] = {
+  SONG_SKIP(16)
+};
+
+// bar 1 - treble clef
+static const uint8_t bar1[] = {
+  SONG_NOTE(60, 5), SONG_SKIP(1), SONG_NOTE(72, 5), SONG_SKIP(1),
+  SONG_NOTE(67, 5), SONG_SKIP(1), SONG_NOTE(64, 5), SONG_SKIP(1),
+  SONG_NOTE(72, 5), SONG_NOTE(67, 5), SONG_NOTE(60, 5), SONG_SKIP(1),
+  SONG_NOTE(64, 5), SONG_SKIP(3)
+};
+
+// bar 2 - treble clef
+static const uint8_t bar2[] = {
+  SONG_NOTE(61, 5), SONG_SKIP(1), SONG_NOTE(73, 5), SONG_SKIP(1),
+  SONG_NOTE(68, 5), SONG_SKIP(1), SONG_NOTE(65, 5), SONG_SKIP(1),
+  SONG_NOTE(73, 5), SONG_NOTE(68, 5), SONG_NOTE(61, 5), SONG_SKIP(1),
+  SONG_NOTE(65, 5), SONG_SKIP(3)
+};
+
+// bar 3 - treble clef
+static const uint8_t bar3[] = {
+  SONG_NOTE(64, 5), SONG_NOTE(65, 5), SONG_NOTE(66, 5), SONG_SKIP(1),
+  SONG_NOTE(66, 5), SONG_NOTE(67, 5), SONG_NOTE(68, 5), SONG_SKIP(1),
+  SONG_NOTE(68, 5), SONG_NOTE(69, 5), SONG_NOTE(70, 5), SONG_SKIP(1),
+  SONG_NOTE(72, 5), SONG_SKIP(3)
+};
+
+// bar 4 - bass #1
+static const uint8_t bar4[] = {
+  SONG_NOTE(48, 5), SONG_SKIP(5), SONG_NOTE(55, 5), SONG_SKIP(1),
+  SONG_NOTE(48, 5), SONG_SKIP(5), SONG_NOTE(56, 5), SONG_SKIP(1)
+};
+
+// bar 5 - bass #2
+static const uint8_t bar5[] = {
+  SONG_NOTE(49, 5), SONG_SKIP(5), SONG_NOTE(56, 5), SONG_SKIP(1),
+  SONG_NOTE(49, 5), SONG_SKIP(5), SONG_NOTE(55, 5), SONG_SKIP(1)
+};
+
+// bar 6 - bass #3
+static const uint8_t bar6[] = {
+  SONG_NOTE(48, 5), SONG_SKIP(5), SONG_NOTE(55, 5), SONG_SKIP(1),
+  SONG_NOTE(48, 5), SONG_SKIP(5), SONG_NOTE(55, 5), SONG_SKIP(1)
+};
+
+// bar 7 - bass #4
+static const uint8_t bar7[] = {
+  SONG_NOTE(55, 5), SONG_SKIP(3), SONG_NOTE(56, 5), SONG_SKIP(3),
+  SONG_NOTE(58, 5), SONG_SKIP(3), SONG_NOTE(60, 5), SONG_SKIP(3)
+};
+
+// bar 8 = pacman death sound effect
+static const uint8_t bar8[] = {
+  SONG_NOTE_FX(80, 6, 2, 1),  // G5, slide down
+  SONG_FX(1, 1),              // slide back up
+  SONG_NOTE_FX(78, 6, 2, 1),  // F5, slide down
+  SONG_FX(1, 1),              // slide back up
+  SONG_NOTE_FX(77, 6, 2, 1),  // E5, slide down
+  SONG_FX(1, 1),              // slide back up
+  SONG_NOTE_FX(75, 6, 2, 1),  // D5, slide down
+  SONG_FX(1, 1),              // slide back up
+  SONG_NOTE_FX(73, 6, 2, 1),  // C5, slide down
+  SONG_FX(1, 1),              // slide back up
+  SONG_NOTE_FX(72, 6, 2, 1),  // B5, slide down .. but .. break this one off early so there's room to cut the volume at the last row
+  SONG_NOTE_FX(56, 6, 1, 5),  // start at G3, slide up 5 semitones at a time; "whup whup" at the end.
+  SONG_FX(1, 5),              // .. keep sliding up
+  SONG_NOTE_FX(56, 6, 1, 5),  // reset back to G3 ^^^^^
+  SONG_FX(1, 5),              // ^^^^^^^^^^^^^^
+  SONG_FX(12, 0)              // set volume to zero to end effect
+};
+
+// bar 9 = eat pill sound effect
+static const uint8_t bar9[] = {
+  SONG_NOTE_FX(80, 7, 2, 4),  // G5, slide down
+  SONG_FX(2, 4),              // keep sliding down
+  SONG_FX(1, 4),              // slide back up
+  SONG_FX(1, 4),              // keep sliding back up
+  SONG_FX(12, 0),             // set volume to zero to end effect
+  SONG_SKIP(11)
+};
+
+// bar 10 = waka waka
+static const uint8_t bar10[] = {
+  SONG_NOTE_FX(72, 8, 2, 4),  // Start @ B5, slide down
+  SONG_FX(12, 0),             // volume off
+  SONG_NOTE_FX(56, 8, 1, 4),  // start @ G4 and slide up
+  SONG_FX(12, 0),             // set volume to zero to end effect
+  SONG_SKIP(12)
+};
+
+static const uint8_t * const bars[] = {
+  bar0, bar1, bar2, bar3, bar4, bar5, bar6, bar7, bar8, bar9, bar10
+};
+
+static const struct song_pattern_t patterns[] = {
+  { .bar = { 1,4,0,0 } },
+  { .bar = { 2,5,0,0 } },
+  { .bar = { 1,6,0,0 } },
+  { .bar = { 3,7,0,0 } },
+  { .bar = { 0,0,0,0 } }
+};
+
+static const uint8_t pattern_map[] = { 0,1,2,3,4,4,4,4 };
+
+const struct song_t song_pacman = {
+  .song_length = 8,
+  .rows_per_bar = 16,
+  .ticks_per_div = 4,
+  .instruments = instruments,
+  .pattern_map = pattern_map,
+  .patterns = patterns,
+  .bars = bars,
+  .num_bars = sizeof(bars) / sizeof(bars[0])
+};
@@ -0,0 +1,37 @@
+#include "timer.h"
+#include <irqctl/irqctl.h>
+
+static timer_callback_t timer_callbacks[TIMER_CHANNELS];
+
+// the IRQCTL_TIMER handler: clears each channel that fired and calls it
+static void timer_dispatch(void) {
+  uint32_t fired = reg_timer_status;
+  reg_timer_status = fired;
+
+  for (int channel = 0; fired != 0; channel++, fired >>= 1)
+    if ((fired & 1) && timer_callbacks[channel])
+      timer_callbacks[channel]();
+}
+
+static void timer_start(int channel, uint32_t delay_us, uint32_t period_us, timer_callback_t callback) {
+  timer_cancel(channel);
+  timer_callbacks[channel] = callback;
+  irqctl_set_handler(IRQCTL_TIMER, timer_dispatch);
+
+  reg_timer_period(channel) = period_us;
+  reg_timer_compare(channel) = timer_now() + delay_us;
+  reg_timer_enable_set = 1 << channel;
+}
+
+void timer_oneshot(int channel, uint32_t delay_us, timer_callback_t callback) {
+  timer_start(channel, delay_us, 0, callback);
+}
+
+void timer_periodic(int channel, uint32_t period_us, timer_callback_t callback) {
+  timer_start(channel, period_us, period_us, callback);
+}
+
+void timer_cancel(int channel) {
+  reg_timer_enable_clear = 1 << channel;
+  reg_timer_status = 1 << channel;
+}
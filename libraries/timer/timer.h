@@ -0,0 +1,42 @@
+#ifndef __TINYSOC_TIMER__
+#define __TINYSOC_TIMER__
+
+#include <stdint.h>
+
+// timer peripheral (hardware built with -Dtimer, see
+// hdl/picosoc/timer/README.md).  Callbacks also need the interrupt
+// controller (-Dirqctl, libraries/irqctl/irqctl.c) and IRQ_5 unmasked.
+#define reg_timer_cycles  (*(volatile uint32_t*)0x0c000000)
+#define reg_timer_us      (*(volatile uint32_t*)0x0c000004)
+#define reg_timer_status  (*(volatile uint32_t*)0x0c000008)
+#define reg_timer_enable  (*(volatile uint32_t*)0x0c00000c)
+#define reg_timer_enable_set   (*(volatile uint32_t*)0x0c000040)   // write 1s to enable
+#define reg_timer_enable_clear (*(volatile uint32_t*)0x0c000044)   // write 1s to disable
+#define reg_timer_compare(channel) (*(volatile uint32_t*)(0x0c000010 + 8 * (channel)))
+#define reg_timer_period(channel)  (*(volatile uint32_t*)(0x0c000014 + 8 * (channel)))
+
+#define TIMER_CHANNELS 4
+
+typedef void (*timer_callback_t)(void);
+
+// microseconds since reset (wraps after 71 minutes)
+static inline uint32_t timer_now(void) {
+  return reg_timer_us;
+}
+
+// clocks since reset (wraps after 268s at 16MHz)
+static inline uint32_t timer_cycles(void) {
+  return reg_timer_cycles;
+}
+
+// call callback, from the interrupt, once after delay_us (under 2^31)
+void timer_oneshot(int channel, uint32_t delay_us, timer_callback_t callback);
+
+// call callback every period_us (1 to 2^31), the first time period_us
+// from now; the period does not drift with interrupt latency
+void timer_periodic(int channel, uint32_t period_us, timer_callback_t callback);
+
+// stop channel; its callback is not called again
+void timer_cancel(int channel);
+
+#endif
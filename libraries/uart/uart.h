@@ -4,6 +4,16 @@
 #ifndef __UART_H__
 #define __UART_H__
 
+// system clock, set by tiny_soc.mk from SYS_CLK_MHZ
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ 16000000
+#endif
+
+// reg_uart_clkdiv for the baud rate nearest to baud
+#define UART_CLKDIV(baud) ((SYS_CLK_HZ + (baud) / 2) / (baud))
+
+// these wait only while the UART's 16 byte TX FIFO is full; libraries/log
+// doesn't wait at all
 void putchar(char c);
 void print(const char *p);
 void print_hex(unsigned int val, int digits);
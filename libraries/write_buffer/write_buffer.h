@@ -0,0 +1,16 @@
+#ifndef __TINYSOC_WRITE_BUFFER__
+#define __TINYSOC_WRITE_BUFFER__
+
+#include <stdint.h>
+
+// posted write buffer (hardware built with -Dwrite_buffer, see
+// hdl/picosoc/write_buffer/README.md).  Peripheral reads already wait for
+// earlier stores; this is for ordering them against everything else.
+#define reg_write_barrier (*(volatile uint32_t*)0x0e000000)
+
+// wait until every peripheral store so far has been written
+static inline void write_barrier(void) {
+  (void)reg_write_barrier;
+}
+
+#endif
@@ -0,0 +1,892 @@
+//
+// modimport - convert a ProTracker (.mod) or FastTracker II (.xm) module into
+// a song_t source file for libraries/songplayer.
+//
+// The songplayer has three music voices, a fixed 50Hz tick and a handful of
+// effects, so the conversion is necessarily lossy:
+//
+//  - three module channels are imported (-c picks which)
+//  - each sample/instrument is analysed and mapped onto one of the audio
+//    peripheral's waveforms, with a volume envelope sampled at 50Hz
+//  - portamento up/down, set volume, position jump and set speed are kept,
+//    other effects are dropped (and counted)
+//
+// Module patterns are cut into bars of rows_per_bar rows, identical bars and
+// identical bar combinations are stored once, and rows_per_bar is chosen to
+// give the smallest tables unless given with -b.
+//
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// must match libraries/songplayer/songplayer.h and libraries/audio/audio.h
+static const int FIRST_USER_INSTRUMENT = 5;
+static const int MAX_INSTRUMENTS = 32;       // 5 bit instrument field
+static const int MAX_NOTE = 127;             // 7 bit note field
+static const int MAX_SKIP = 128;
+static const int MAX_ENVELOPE_POINTS = 16;
+
+static const int SONG_ROW_NOTE = 0x80;
+static const int SONG_FIELD_INSTRUMENT = 0x01;
+static const int SONG_FIELD_NOTE = 0x02;
+static const int SONG_FIELD_EFFECT = 0x08;
+
+static const int WAVE_NOISE = 8;
+static const int WAVE_SQUARE = 4;
+static const int WAVE_SAWTOOTH = 2;
+static const int WAVE_TRIANGLE = 1;
+
+static const int EFFECT_SLIDE_UP = 0x1;
+static const int EFFECT_SLIDE_DOWN = 0x2;
+static const int EFFECT_POSITION_JUMP = 0xb;
+static const int EFFECT_SET_VOLUME = 0xc;
+static const int EFFECT_SET_SPEED = 0xf;
+
+static const int KEY_OFF = -1;
+
+// volume envelopes of the percussion instruments in libraries/songs
+static const int drum_envelopes[5][16] = {
+  { 0 },
+  { 0x00, 0xff, 0xff, 0x80, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+  { 0x80, 0x60, 0x40, 0x20, 0x10, 0x08, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+  { 0x80, 0x60, 0x40, 0x20, 0x10, 0x08, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+  { 0xff, 0xff, 0xc0, 0x80, 0x40, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+};
+
+// ProTracker C-2 (period 428) and FastTracker C-4 both become MIDI C4,
+// which is note 61 in songplayer's note_to_freq[] table
+static const int MOD_C2_NOTE = 61;
+static const int XM_NOTE_OFFSET = 12;
+
+// sample rate at which a ProTracker C-2 / FastTracker C-4 plays a sample
+static const double C_SAMPLE_RATE = 8363.0;
+static const double TICK_HZ = 50.0;
+
+struct Cell {
+  int note;        // songplayer note number, 0 = none, KEY_OFF
+  int instrument;  // module instrument number, 0 = none
+  int volume;      // 0..64, -1 = none
+  int effect;
+  int param;
+};
+
+struct Sample {
+  std::string name;
+  std::vector<float> data;      // -1..1
+  int volume;                   // 0..64
+  uint32_t loop_start, loop_length;
+  int relative_note;
+  std::vector<int> envelope;    // per 50Hz tick, 0..64 (XM volume envelope)
+};
+
+struct Module {
+  std::string title;
+  bool xm;
+  bool linear_slides;
+  int channels;
+  int speed;
+  std::vector<int> order;
+  std::vector<std::vector<std::vector<Cell> > > patterns;  // [pattern][row][channel]
+  std::vector<Sample> samples;                             // instrument n is samples[n-1]
+};
+
+static void die(const char *msg) {
+  fprintf(stderr, "modimport: %s\n", msg);
+  exit(1);
+}
+
+static std::vector<uint8_t> read_file(const char *name) {
+  FILE *f = fopen(name, "rb");
+  if (!f) {
+    perror(name);
+    exit(1);
+  }
+  std::vector<uint8_t> data;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+  fclose(f);
+  return data;
+}
+
+// bounds checked little/big endian readers
+struct Reader {
+  const std::vector<uint8_t> &d;
+  Reader(const std::vector<uint8_t> &data) : d(data) {}
+  void need(size_t pos, size_t len) const { if (pos + len > d.size()) die("truncated module"); }
+  uint8_t u8(size_t pos) const { need(pos, 1); return d[pos]; }
+  uint16_t be16(size_t pos) const { need(pos, 2); return (d[pos] << 8) | d[pos+1]; }
+  uint16_t le16(size_t pos) const { need(pos, 2); return d[pos] | (d[pos+1] << 8); }
+  uint32_t le32(size_t pos) const { need(pos, 4); return le16(pos) | ((uint32_t)le16(pos+2) << 16); }
+  std::string str(size_t pos, size_t len) const {
+    need(pos, len);
+    std::string s((const char *)&d[pos], len);
+    s = s.substr(0, s.find('\0'));
+    while (!s.empty() && s[s.size()-1] == ' ') s.erase(s.size()-1);
+    return s;
+  }
+};
+
+static int period_to_note(int period) {
+  if (period == 0) return 0;
+  return MOD_C2_NOTE + (int)lround(12.0 * log2(428.0 / period));
+}
+
+static Module load_mod(const std::vector<uint8_t> &file) {
+  Reader r(file);
+  Module m;
+  m.xm = false;
+  m.linear_slides = false;
+  m.speed = 6;
+  m.title = r.str(0, 20);
+
+  std::string sig = r.str(1080, 4);
+  if (sig == "M.K." || sig == "M!K!" || sig == "FLT4" || sig == "4CHN") m.channels = 4;
+  else if (sig.size() == 4 && sig.substr(1) == "CHN" && sig[0] >= '1' && sig[0] <= '9') m.channels = sig[0] - '0';
+  else if (sig.size() == 4 && sig.substr(2) == "CH") m.channels = atoi(sig.substr(0, 2).c_str());
+  else die("not a 31 sample ProTracker module");
+  if (m.channels <= 0) die("bad channel count");
+
+  int song_length = r.u8(950);
+  int num_patterns = 0;
+  for (int i = 0; i < song_length; i++) {
+    int p = r.u8(952 + i);
+    m.order.push_back(p);
+    if (p + 1 > num_patterns) num_patterns = p + 1;
+  }
+  // patterns only referenced past the song length are still stored
+  for (int i = song_length; i < 128; i++)
+    if (r.u8(952 + i) + 1 > num_patterns) num_patterns = r.u8(952 + i) + 1;
+
+  size_t pos = 1084;
+  for (int p = 0; p < num_patterns; p++) {
+    std::vector<std::vector<Cell> > rows(64, std::vector<Cell>(m.channels));
+    for (int row = 0; row < 64; row++) {
+      for (int c = 0; c < m.channels; c++, pos += 4) {
+        r.need(pos, 4);
+        Cell &cell = rows[row][c];
+        cell.note = period_to_note(((file[pos] & 0x0f) << 8) | file[pos+1]);
+        cell.instrument = (file[pos] & 0xf0) | (file[pos+2] >> 4);
+        cell.volume = -1;
+        cell.effect = file[pos+2] & 0x0f;
+        cell.param = file[pos+3];
+      }
+    }
+    m.patterns.push_back(rows);
+  }
+
+  for (int s = 0; s < 31; s++) {
+    size_t h = 20 + s * 30;
+    Sample smp;
+    smp.name = r.str(h, 22);
+    uint32_t length = r.be16(h + 22) * 2;
+    smp.volume = r.u8(h + 25);
+    if (smp.volume > 64) smp.volume = 64;
+    smp.loop_start = r.be16(h + 26) * 2;
+    smp.loop_length = r.be16(h + 28) * 2;
+    if (smp.loop_length <= 2) smp.loop_length = 0;
+    smp.relative_note = 0;
+    for (uint32_t i = 0; i < length && pos + i < file.size(); i++)
+      smp.data.push_back((int8_t)file[pos + i] / 128.0f);
+    pos += length;
+    m.samples.push_back(smp);
+  }
+  return m;
+}
+
+static Module load_xm(const std::vector<uint8_t> &file) {
+  Reader r(file);
+  Module m;
+  m.xm = true;
+  m.title = r.str(17, 20);
+
+  uint32_t header_size = r.le32(60);
+  int song_length = r.le16(64);
+  m.channels = r.le16(68);
+  int num_patterns = r.le16(70);
+  int num_instruments = r.le16(72);
+  m.linear_slides = r.le16(74) & 1;
+  m.speed = r.le16(76);
+  for (int i = 0; i < song_length && i < 256; i++) m.order.push_back(r.u8(80 + i));
+
+  size_t pos = 60 + header_size;
+  for (int p = 0; p < num_patterns; p++) {
+    uint32_t pattern_header = r.le32(pos);
+    int num_rows = r.le16(pos + 5);
+    size_t packed_size = r.le16(pos + 7);
+    pos += pattern_header;
+
+    std::vector<std::vector<Cell> > rows(num_rows, std::vector<Cell>(m.channels));
+    size_t end = pos + packed_size;
+    for (int row = 0; row < num_rows; row++) {
+      for (int c = 0; c < m.channels; c++) {
+        int note = 0, instrument = 0, volume = 0, effect = 0, param = 0;
+        if (pos < end) {
+          uint8_t b = r.u8(pos++);
+          int mask = (b & 0x80) ? b : 0x1f;
+          if (!(b & 0x80)) pos--;
+          if (mask & 0x01) note = r.u8(pos++);
+          if (mask & 0x02) instrument = r.u8(pos++);
+          if (mask & 0x04) volume = r.u8(pos++);
+          if (mask & 0x08) effect = r.u8(pos++);
+          if (mask & 0x10) param = r.u8(pos++);
+        }
+        Cell &cell = rows[row][c];
+        cell.note = note == 97 ? KEY_OFF : (note ? note + XM_NOTE_OFFSET : 0);
+        cell.instrument = instrument;
+        cell.volume = (volume >= 0x10 && volume <= 0x50) ? volume - 0x10 : -1;
+        cell.effect = effect;
+        cell.param = param;
+      }
+    }
+    pos = end;
+    m.patterns.push_back(rows);
+  }
+
+  for (int i = 0; i < num_instruments; i++) {
+    uint32_t instrument_size = r.le32(pos);
+    Sample smp;
+    smp.name = r.str(pos + 4, 22);
+    smp.volume = 0;
+    smp.loop_start = smp.loop_length = 0;
+    smp.relative_note = 0;
+    int num_samples = r.le16(pos + 27);
+    if (num_samples == 0) {
+      pos += instrument_size;
+      m.samples.push_back(smp);
+      continue;
+    }
+
+    uint32_t sample_header_size = r.le32(pos + 29);
+    int c4_sample = r.u8(pos + 33 + 48);    // keymap entry for C-4
+    int env_points = r.u8(pos + 225);
+    int env_sustain = r.u8(pos + 227);
+    int env_flags = r.u8(pos + 233);
+    if ((env_flags & 1) && env_points > 0) {
+      // sample the envelope once per tick, up to the sustain point
+      int last = (env_flags & 2) ? env_sustain : env_points - 1;
+      if (last >= env_points) last = env_points - 1;
+      int last_x = r.le16(pos + 129 + last * 4);
+      for (int x = 0, pt = 0; x <= last_x && (int)smp.envelope.size() < MAX_ENVELOPE_POINTS; x++) {
+        while (pt < last && r.le16(pos + 129 + (pt+1) * 4) <= x) pt++;
+        int x0 = r.le16(pos + 129 + pt * 4), y0 = r.le16(pos + 131 + pt * 4);
+        int x1 = x0, y1 = y0;
+        if (pt < last) {
+          x1 = r.le16(pos + 129 + (pt+1) * 4);
+          y1 = r.le16(pos + 131 + (pt+1) * 4);
+        }
+        smp.envelope.push_back(x1 > x0 ? y0 + (y1 - y0) * (x - x0) / (x1 - x0) : y0);
+      }
+    }
+    pos += instrument_size;
+
+    std::vector<uint32_t> lengths;
+    std::vector<bool> wide;
+    for (int s = 0; s < num_samples; s++, pos += sample_header_size) {
+      uint32_t length = r.le32(pos);
+      int type = r.u8(pos + 14);
+      lengths.push_back(length);
+      wide.push_back(type & 0x10);
+      if (s == c4_sample || (s == 0 && c4_sample >= num_samples)) {
+        smp.loop_start = r.le32(pos + 4);
+        smp.loop_length = (type & 3) ? r.le32(pos + 8) : 0;
+        smp.volume = r.u8(pos + 12);
+        smp.relative_note = (int8_t)r.u8(pos + 16);
+        if (type & 0x10) {
+          smp.loop_start /= 2;
+          smp.loop_length /= 2;
+        }
+      }
+    }
+    for (int s = 0; s < num_samples; s++) {
+      // delta encoded 8 or 16 bit data
+      bool keep = s == c4_sample || (s == 0 && c4_sample >= num_samples);
+      int acc = 0;
+      if (wide[s]) {
+        for (uint32_t b = 0; b + 1 < lengths[s]; b += 2) {
+          acc = (int16_t)(acc + r.le16(pos + b));
+          if (keep) smp.data.push_back(acc / 32768.0f);
+        }
+      } else {
+        for (uint32_t b = 0; b < lengths[s]; b++) {
+          acc = (int8_t)(acc + r.u8(pos + b));
+          if (keep) smp.data.push_back(acc / 128.0f);
+        }
+      }
+      pos += lengths[s];
+    }
+    if (smp.volume > 64) smp.volume = 64;
+    m.samples.push_back(smp);
+  }
+  return m;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Instrument mapping
+/////////////////////////////////////////////////////////////////////
+
+struct Instrument {
+  int waveform;
+  int pulsewidth;
+  int default_volume;
+  int envelope;          // index into envelopes, -1 = none
+  std::string comment;
+
+  bool operator<(const Instrument &o) const {
+    if (waveform != o.waveform) return waveform < o.waveform;
+    if (pulsewidth != o.pulsewidth) return pulsewidth < o.pulsewidth;
+    if (default_volume != o.default_volume) return default_volume < o.default_volume;
+    return envelope < o.envelope;
+  }
+};
+
+// pick the audio peripheral waveform closest to a sample's (looped) shape
+static int classify_waveform(const Sample &s, int *pulsewidth) {
+  *pulsewidth = 2048;
+  if (s.data.size() < 4) return WAVE_SQUARE;
+
+  size_t start = 0, end = s.data.size();
+  if (s.loop_length && s.loop_start + s.loop_length <= end) {
+    start = s.loop_start;
+    end = s.loop_start + s.loop_length;
+  }
+
+  float peak = 0;
+  double mean_abs = 0, mean_step = 0, rising = 0, falling = 0;
+  size_t positive = 0, near_peak = 0;
+  for (size_t i = start; i < end; i++) peak = fmaxf(peak, fabsf(s.data[i]));
+  if (peak == 0) return WAVE_SQUARE;
+  for (size_t i = start; i < end; i++) {
+    float v = s.data[i] / peak;
+    mean_abs += fabs(v);
+    if (v > 0) positive++;
+    if (fabs(v) > 0.8) near_peak++;
+    if (i > start) {
+      float step = v - s.data[i-1] / peak;
+      mean_step += fabs(step);
+      if (step > 0) rising += step; else falling -= step;
+    }
+  }
+  size_t n = end - start;
+  mean_abs /= n;
+  mean_step /= n;
+
+  // noise jumps about by a large fraction of its amplitude every sample
+  if (mean_step > 0.5 * mean_abs && !s.loop_length) return WAVE_NOISE;
+  if (mean_step > 0.8 * mean_abs) return WAVE_NOISE;
+
+  if ((double)near_peak / n > 0.7) {
+    *pulsewidth = (int)(4096.0 * positive / n);
+    if (*pulsewidth < 1) *pulsewidth = 1;
+    if (*pulsewidth > 4095) *pulsewidth = 4095;
+    return WAVE_SQUARE;
+  }
+
+  // a sawtooth ramps slowly one way and jumps back the other; a triangle
+  // ramps the same amount both ways.  Compare how often each direction is
+  // taken with how far it travels.
+  size_t ups = 0, downs = 0;
+  for (size_t i = start + 1; i < end; i++) {
+    if (s.data[i] > s.data[i-1]) ups++;
+    else if (s.data[i] < s.data[i-1]) downs++;
+  }
+  if (ups + downs == 0) return WAVE_SQUARE;
+  double up_share = (double)ups / (ups + downs);
+  if (up_share > 0.7 || up_share < 0.3) return WAVE_SAWTOOTH;
+  return WAVE_TRIANGLE;
+}
+
+// volume per 50Hz tick (0..255), from the sample's own amplitude
+static std::vector<int> sample_envelope(const Sample &s) {
+  std::vector<int> points;
+  double step = C_SAMPLE_RATE * pow(2.0, s.relative_note / 12.0) / TICK_HZ;
+  float peak = 0;
+  for (size_t i = 0; i < s.data.size(); i++) peak = fmaxf(peak, fabsf(s.data[i]));
+  if (peak == 0) return points;
+
+  for (int t = 0; t < MAX_ENVELOPE_POINTS; t++) {
+    size_t from = (size_t)(t * step), to = (size_t)((t + 1) * step);
+    float level = 0;
+    for (size_t i = from; i < to; i++) {
+      size_t idx = i;
+      if (idx >= s.data.size()) {
+        if (!s.loop_length) break;
+        idx = s.loop_start + (idx - s.loop_start) % s.loop_length;
+        if (idx >= s.data.size()) break;
+      }
+      level = fmaxf(level, fabsf(s.data[idx]));
+    }
+    points.push_back((int)lround(255.0 * s.volume / 64.0 * level / peak));
+  }
+  return points;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Bar encoding
+/////////////////////////////////////////////////////////////////////
+
+struct Row {
+  int note, instrument, effect, param;
+  bool empty() const { return !note && !instrument && !effect && !param; }
+};
+
+struct EncodedBar {
+  std::vector<uint8_t> bytes;
+  std::vector<std::string> tokens;
+};
+
+static std::string fmt(const char *f, ...) __attribute__((format(printf, 1, 2)));
+static std::string fmt(const char *f, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, f);
+  vsnprintf(buf, sizeof(buf), f, ap);
+  va_end(ap);
+  return buf;
+}
+
+static EncodedBar encode_bar(const std::vector<Row> &rows) {
+  EncodedBar bar;
+  int skip = 0;
+  for (size_t i = 0; i <= rows.size(); i++) {
+    if (i < rows.size() && rows[i].empty() && skip < MAX_SKIP) {
+      skip++;
+      continue;
+    }
+    if (skip) {
+      bar.bytes.push_back(skip - 1);
+      bar.tokens.push_back(fmt("SONG_SKIP(%d)", skip));
+      skip = 0;
+    }
+    if (i == rows.size()) break;
+    if (rows[i].empty()) {
+      skip = 1;
+      continue;
+    }
+
+    const Row &r = rows[i];
+    bool fx = r.effect || r.param;
+    int fields = SONG_ROW_NOTE | (r.instrument ? SONG_FIELD_INSTRUMENT : 0)
+               | (r.note ? SONG_FIELD_NOTE : 0) | (fx ? SONG_FIELD_EFFECT : 0);
+    bar.bytes.push_back(fields);
+    if (r.instrument) bar.bytes.push_back(r.instrument);
+    if (r.note) bar.bytes.push_back(r.note);
+    if (fx) {
+      bar.bytes.push_back(r.effect);
+      bar.bytes.push_back(r.param);
+    }
+
+    if (r.note && r.instrument && fx)
+      bar.tokens.push_back(fmt("SONG_NOTE_FX(%d, %d, %d, %d)", r.note, r.instrument, r.effect, r.param));
+    else if (r.note && r.instrument)
+      bar.tokens.push_back(fmt("SONG_NOTE(%d, %d)", r.note, r.instrument));
+    else if (!r.note && !r.instrument)
+      bar.tokens.push_back(fmt("SONG_FX(%d, %d)", r.effect, r.param));
+    else {
+      std::string t = "(SONG_ROW_NOTE";
+      if (r.instrument) t += " | SONG_FIELD_INSTRUMENT";
+      if (r.note) t += " | SONG_FIELD_NOTE";
+      if (fx) t += " | SONG_FIELD_EFFECT";
+      t += ")";
+      if (r.instrument) t += fmt(", %d", r.instrument);
+      if (r.note) t += fmt(", %d", r.note);
+      if (fx) t += fmt(", %d, %d", r.effect, r.param);
+      bar.tokens.push_back(t);
+    }
+  }
+  return bar;
+}
+
+struct Layout {
+  int rows_per_bar;
+  std::vector<EncodedBar> bars;
+  std::vector<std::vector<int> > patterns;   // 3 bar numbers each
+  std::vector<int> pattern_map;
+  size_t bytes;
+};
+
+// cut every (module) pattern into bars and share identical ones
+static Layout build_layout(const std::vector<std::vector<std::vector<Row> > > &tracks,
+                           const std::vector<int> &order, int rows_per_bar) {
+  Layout l;
+  l.rows_per_bar = rows_per_bar;
+  std::map<std::vector<uint8_t>, int> bar_index;
+  std::map<std::vector<int>, int> pattern_index;
+
+  for (size_t o = 0; o < order.size(); o++) {
+    const std::vector<std::vector<Row> > &pattern = tracks[order[o]];
+    int rows = pattern[0].size();
+    for (int first = 0; first < rows; first += rows_per_bar) {
+      std::vector<int> bars;
+      for (int c = 0; c < 3; c++) {
+        std::vector<Row> slice(pattern[c].begin() + first, pattern[c].begin() + first + rows_per_bar);
+        EncodedBar bar = encode_bar(slice);
+        std::map<std::vector<uint8_t>, int>::iterator it = bar_index.find(bar.bytes);
+        if (it == bar_index.end()) {
+          it = bar_index.insert(std::make_pair(bar.bytes, (int)l.bars.size())).first;
+          l.bars.push_back(bar);
+        }
+        bars.push_back(it->second);
+      }
+      std::map<std::vector<int>, int>::iterator it = pattern_index.find(bars);
+      if (it == pattern_index.end()) {
+        it = pattern_index.insert(std::make_pair(bars, (int)l.patterns.size())).first;
+        l.patterns.push_back(bars);
+      }
+      l.pattern_map.push_back(it->second);
+    }
+  }
+
+  l.bytes = l.pattern_map.size() + 4 * l.patterns.size() + 4 * l.bars.size();
+  for (size_t b = 0; b < l.bars.size(); b++) l.bytes += l.bars[b].bytes.size();
+  return l;
+}
+
+static int gcd(int a, int b) { return b ? gcd(b, a % b) : a; }
+
+/////////////////////////////////////////////////////////////////////
+
+static void usage() {
+  fprintf(stderr,
+    "usage: modimport [options] module.(mod|xm)\n"
+    "  -n name        song name, the output defines song_<name> (default: song)\n"
+    "  -o file.c      output file (default: stdout)\n"
+    "  -c a,b,c       module channels to import, counting from 0 (default 0,1,2)\n"
+    "  -b rows        rows per bar (default: whichever gives the smallest tables)\n"
+    "  -t semitones   transpose every note\n"
+    "  -d inst:drum   play module instrument inst on songplayer percussion\n"
+    "                 instrument drum (1 kick, 2 closed hihat, 3 open hihat, 4 snare)\n");
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  std::string name = "song";
+  const char *out_name = NULL;
+  int channels[3] = { 0, 1, 2 };
+  int rows_per_bar = 0;
+  int transpose = 0;
+  std::map<int, int> drums;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:o:c:b:t:d:")) != -1) {
+    switch (opt) {
+      case 'n': name = optarg; break;
+      case 'o': out_name = optarg; break;
+      case 'c':
+        if (sscanf(optarg, "%d,%d,%d", &channels[0], &channels[1], &channels[2]) != 3) usage();
+        break;
+      case 'b': rows_per_bar = atoi(optarg); break;
+      case 't': transpose = atoi(optarg); break;
+      case 'd': {
+        int inst, drum;
+        if (sscanf(optarg, "%d:%d", &inst, &drum) != 2 || drum < 1 || drum >= FIRST_USER_INSTRUMENT) usage();
+        drums[inst] = drum;
+        break;
+      }
+      default: usage();
+    }
+  }
+  if (optind != argc - 1) usage();
+
+  std::vector<uint8_t> file = read_file(argv[optind]);
+  bool is_xm = file.size() > 17 && !memcmp(&file[0], "Extended Module: ", 17);
+  Module m = is_xm ? load_xm(file) : load_mod(file);
+
+  for (int c = 0; c < 3; c++)
+    if (channels[c] < 0 || channels[c] >= m.channels) die("channel out of range");
+  if (m.order.empty()) die("module has an empty order list");
+  for (size_t o = 0; o < m.order.size(); o++)
+    if (m.order[o] >= (int)m.patterns.size()) die("order list refers to a missing pattern");
+
+  // ticks per division comes from the first "set speed" in the song
+  int speed = m.speed;
+  bool speed_found = false, speed_changes = false;
+  for (size_t o = 0; o < m.order.size(); o++) {
+    const std::vector<std::vector<Cell> > &p = m.patterns[m.order[o]];
+    for (size_t row = 0; row < p.size(); row++)
+      for (int c = 0; c < m.channels; c++)
+        if (p[row][c].effect == EFFECT_SET_SPEED && p[row][c].param && p[row][c].param < 32) {
+          if (!speed_found) speed = p[row][c].param;
+          else if (p[row][c].param != speed) speed_changes = true;
+          speed_found = true;
+        }
+  }
+  if (speed <= 0) speed = 6;
+
+  // rows per bar must divide every pattern used
+  int row_gcd = 0;
+  for (size_t o = 0; o < m.order.size(); o++) row_gcd = gcd(row_gcd, m.patterns[m.order[o]].size());
+  if (rows_per_bar && row_gcd % rows_per_bar) die("rows per bar must divide the pattern length");
+
+  // map module instruments onto songplayer instruments
+  std::vector<std::vector<int> > envelopes;
+  std::vector<Instrument> instruments;
+  std::map<Instrument, int> instrument_index;
+  std::map<int, int> instrument_map;   // module instrument -> songplayer instrument
+
+  Instrument silent = { 0, 2048, 0, -1, "0 = no instrument" };
+  instruments.push_back(silent);
+  const char *drum_names[] = { "", "kick drum", "closed hihat", "open hihat", "snare" };
+  for (int d = 1; d < FIRST_USER_INSTRUMENT; d++) {
+    Instrument drum = { 0, 2048, 0, -1, fmt("%d = %s", d, drum_names[d]) };
+    instruments.push_back(drum);
+  }
+
+  int dropped_effects = 0, dropped_notes = 0, wrapped_jumps = 0;
+
+  // convert the three imported channels of every pattern
+  std::vector<std::vector<std::vector<Row> > > tracks(m.patterns.size());
+  for (size_t p = 0; p < m.patterns.size(); p++) {
+    const std::vector<std::vector<Cell> > &pattern = m.patterns[p];
+    tracks[p].resize(3);
+    for (int c = 0; c < 3; c++) {
+      int last_instrument = 0;
+      for (size_t row = 0; row < pattern.size(); row++) {
+        const Cell &cell = pattern[row][channels[c]];
+        Row out = { 0, 0, 0, 0 };
+
+        if (cell.instrument) last_instrument = cell.instrument;
+        if (cell.note > 0 && last_instrument > 0 && last_instrument <= (int)m.samples.size()) {
+          const Sample &s = m.samples[last_instrument - 1];
+          int note = cell.note + transpose + (m.xm ? s.relative_note : 0);
+          if (note < 1) note = 1;
+          if (note > MAX_NOTE) note = MAX_NOTE;
+
+          std::map<int, int>::iterator it = instrument_map.find(last_instrument);
+          if (it == instrument_map.end()) {
+            int index;
+            if (drums.count(last_instrument)) {
+              index = drums[last_instrument];
+              if (instruments[index].envelope < 0) {
+                std::vector<int> env(drum_envelopes[index], drum_envelopes[index] + MAX_ENVELOPE_POINTS);
+                while (env.size() > 1 && env[env.size()-1] == env[env.size()-2]) env.pop_back();
+                size_t e = 0;
+                while (e < envelopes.size() && envelopes[e] != env) e++;
+                if (e == envelopes.size()) envelopes.push_back(env);
+                instruments[index].envelope = e;
+              }
+            } else {
+              Instrument inst;
+              inst.waveform = classify_waveform(s, &inst.pulsewidth);
+              std::vector<int> env;
+              if (!s.envelope.empty()) {
+                for (size_t i = 0; i < s.envelope.size(); i++)
+                  env.push_back((int)lround(255.0 * s.envelope[i] * s.volume / (64.0 * 64.0)));
+              } else {
+                env = sample_envelope(s);
+              }
+              while (env.size() > 1 && env[env.size()-1] == env[env.size()-2]) env.pop_back();
+              inst.default_volume = (int)lround(255.0 * s.volume / 64.0);
+              inst.envelope = -1;
+              if (env.size() > 1) {
+                size_t e = 0;
+                while (e < envelopes.size() && envelopes[e] != env) e++;
+                if (e == envelopes.size()) envelopes.push_back(env);
+                inst.envelope = e;
+              } else if (env.size() == 1) {
+                inst.default_volume = env[0];
+              }
+              std::map<Instrument, int>::iterator found = instrument_index.find(inst);
+              if (found != instrument_index.end()) {
+                index = found->second;
+                instruments[index].comment += ", " + s.name;
+              } else {
+                index = instruments.size();
+                if (index >= MAX_INSTRUMENTS) die("too many distinct instruments (at most 27)");
+                inst.comment = fmt("%d = ", index) + (s.name.empty() ? fmt("instrument %d", last_instrument) : s.name);
+                instrument_index[inst] = index;
+                instruments.push_back(inst);
+              }
+            }
+            it = instrument_map.insert(std::make_pair(last_instrument, index)).first;
+          }
+          out.note = note;
+          out.instrument = it->second;
+        } else if (cell.note > 0) {
+          dropped_notes++;
+        }
+
+        switch (cell.effect) {
+          case 0x0:
+            if (cell.param) dropped_effects++;
+            break;
+          case EFFECT_SLIDE_UP:
+          case EFFECT_SLIDE_DOWN: {
+            // songplayer slides in whole semitones per tick
+            int semitones = (int)lround(cell.param / (m.linear_slides ? 16.0 : 24.0));
+            if (!semitones && cell.param) semitones = 1;
+            if (semitones) {
+              out.effect = cell.effect;
+              out.param = semitones;
+            }
+            break;
+          }
+          case EFFECT_SET_VOLUME:
+            out.effect = EFFECT_SET_VOLUME;
+            out.param = cell.param >= 64 ? 255 : cell.param * 4;
+            break;
+          case EFFECT_POSITION_JUMP:
+            // fixed up once the layout (and so the bars per pattern) is known
+            // a jump past the last position restarts the song, as in a tracker
+            out.effect = EFFECT_POSITION_JUMP;
+            out.param = (size_t)cell.param < m.order.size() ? cell.param : 0;
+            if ((size_t)cell.param >= m.order.size()) wrapped_jumps++;
+            break;
+          case EFFECT_SET_SPEED:
+            break;
+          default:
+            dropped_effects++;
+            break;
+        }
+
+        // a volume column entry that only restates the sample volume would
+        // override the instrument's envelope for the whole row
+        bool default_volume = out.note && cell.volume == m.samples[last_instrument - 1].volume;
+        if (!out.effect && cell.volume >= 0 && !default_volume) {
+          out.effect = EFFECT_SET_VOLUME;
+          out.param = cell.volume >= 64 ? 255 : cell.volume * 4;
+        }
+        if (cell.note == KEY_OFF && !out.effect) {
+          out.effect = EFFECT_SET_VOLUME;
+          out.param = 0;
+        }
+        tracks[p][c].push_back(out);
+      }
+    }
+  }
+
+  int dropped_channel_notes = 0;
+  for (size_t o = 0; o < m.order.size(); o++) {
+    const std::vector<std::vector<Cell> > &p = m.patterns[m.order[o]];
+    for (size_t row = 0; row < p.size(); row++)
+      for (int c = 0; c < m.channels; c++)
+        if (c != channels[0] && c != channels[1] && c != channels[2] && p[row][c].note > 0)
+          dropped_channel_notes++;
+  }
+
+  // pick the bar length giving the smallest tables
+  Layout best;
+  best.bytes = SIZE_MAX;
+  for (int rpb = 1; rpb <= row_gcd; rpb++) {
+    if (row_gcd % rpb || (rows_per_bar && rpb != rows_per_bar)) continue;
+
+    // position jumps are in module order positions; scale to bars
+    // (a target past 255 can't be stored: this bar length won't do)
+    std::vector<std::vector<std::vector<Row> > > scaled = tracks;
+    bool jumps_fit = true;
+    for (size_t p = 0; p < scaled.size(); p++)
+      for (int c = 0; c < 3; c++)
+        for (size_t row = 0; row < scaled[p][c].size(); row++) {
+          Row &r = scaled[p][c][row];
+          if (r.effect != EFFECT_POSITION_JUMP) continue;
+          int target = 0;
+          for (int o = 0; o < r.param && o < (int)m.order.size(); o++)
+            target += m.patterns[m.order[o]].size() / rpb;
+          if (target > 255) jumps_fit = false;
+          r.param = target;
+        }
+    if (!jumps_fit) continue;
+
+    Layout l = build_layout(scaled, m.order, rpb);
+    if (l.bars.size() > 256 || l.patterns.size() > 256) continue;
+    if (l.bytes < best.bytes) best = l;
+  }
+  if (best.bytes == SIZE_MAX) die("song does not fit in 256 bars / 256 patterns");
+
+  FILE *out = stdout;
+  if (out_name && !(out = fopen(out_name, "w"))) {
+    perror(out_name);
+    return 1;
+  }
+
+  fprintf(out, "// generated by modimport from %s", argv[optind]);
+  if (!m.title.empty()) fprintf(out, " (\"%s\")", m.title.c_str());
+  fprintf(out, "\n\n#include <songplayer/songplayer.h>\n#include <audio/audio.h>\n\n");
+
+  for (size_t e = 0; e < envelopes.size(); e++) {
+    fprintf(out, "static const struct envelope_t envelope%zu = {\n", e);
+    fprintf(out, "  .num_points = %zu,\n  .points = {\n   ", envelopes[e].size());
+    for (size_t i = 0; i < envelopes[e].size(); i++)
+      fprintf(out, " 0x%02x%s", envelopes[e][i], i + 1 < envelopes[e].size() ? "," : "");
+    fprintf(out, "\n  }\n};\n\n");
+  }
+
+  const char *wave_names[] = { "WAVE_NONE", "WAVE_TRIANGLE", "WAVE_SAWTOOTH", "", "WAVE_SQUARE", "", "", "", "WAVE_NOISE" };
+  fprintf(out, "static const struct song_instrument_t instruments[] = {\n");
+  for (size_t i = 0; i < instruments.size(); i++) {
+    const Instrument &inst = instruments[i];
+    if (i == FIRST_USER_INSTRUMENT) fprintf(out, "\n");
+    fprintf(out, "  {.waveform_select = %s", wave_names[inst.waveform]);
+    if (inst.envelope >= 0)
+      fprintf(out, ", .envelope = &envelope%d, .envelope_enable=1", inst.envelope);
+    else
+      fprintf(out, ", .envelope_enable=0, .default_volume=%d", inst.default_volume);
+    fprintf(out, ", .pulsewidth = %d}%s  // %s\n", inst.pulsewidth,
+            i + 1 < instruments.size() ? "," : "", inst.comment.c_str());
+  }
+  fprintf(out, "};\n\n");
+
+  for (size_t b = 0; b < best.bars.size(); b++) {
+    const EncodedBar &bar = best.bars[b];
+    fprintf(out, "static const uint8_t bar%zu[] = {", b);
+    size_t col = 1000;
+    for (size_t t = 0; t < bar.tokens.size(); t++) {
+      if (col + bar.tokens[t].size() > 72) {
+        fprintf(out, "\n ");
+        col = 1;
+      }
+      fprintf(out, " %s%s", bar.tokens[t].c_str(), t + 1 < bar.tokens.size() ? "," : "");
+      col += bar.tokens[t].size() + 2;
+    }
+    fprintf(out, "\n};\n\n");
+  }
+
+  fprintf(out, "static const uint8_t * const bars[] = {");
+  for (size_t b = 0; b < best.bars.size(); b++)
+    fprintf(out, "%s bar%zu%s", b % 8 ? "" : "\n ", b, b + 1 < best.bars.size() ? "," : "");
+  fprintf(out, "\n};\n\n");
+
+  fprintf(out, "static const struct song_pattern_t patterns[] = {\n");
+  for (size_t p = 0; p < best.patterns.size(); p++)
+    fprintf(out, "  { .bar = { %d,%d,%d,0 } }%s\n", best.patterns[p][0], best.patterns[p][1],
+            best.patterns[p][2], p + 1 < best.patterns.size() ? "," : "");
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "static const uint8_t pattern_map[] = {");
+  for (size_t i = 0; i < best.pattern_map.size(); i++)
+    fprintf(out, "%s%d%s", i % 16 ? " " : "\n  ", best.pattern_map[i], i + 1 < best.pattern_map.size() ? "," : "");
+  fprintf(out, "\n};\n\n");
+
+  fprintf(out, "const struct song_t song_%s = {\n", name.c_str());
+  fprintf(out, "  .song_length = %zu,\n", best.pattern_map.size());
+  fprintf(out, "  .rows_per_bar = %d,\n", best.rows_per_bar);
+  fprintf(out, "  .ticks_per_div = %d,\n", speed);
+  fprintf(out, "  .instruments = instruments,\n");
+  fprintf(out, "  .pattern_map = pattern_map,\n");
+  fprintf(out, "  .patterns = patterns,\n");
+  fprintf(out, "  .bars = bars,\n");
+  fprintf(out, "  .num_bars = %zu\n};\n", best.bars.size());
+  if (out != stdout) fclose(out);
+
+  size_t instrument_bytes = 12 * instruments.size();
+  for (size_t e = 0; e < envelopes.size(); e++) instrument_bytes += 4 + envelopes[e].size();
+  fprintf(stderr, "song_%s: %zu positions, %zu patterns, %zu bars of %d rows, %zu instruments\n",
+          name.c_str(), best.pattern_map.size(), best.patterns.size(), best.bars.size(),
+          best.rows_per_bar, instruments.size());
+  fprintf(stderr, "about %zu bytes of song tables + %zu bytes of instruments/envelopes\n",
+          best.bytes, instrument_bytes);
+  if (speed_changes) fprintf(stderr, "warning: speed changes during the song, using %d ticks per row throughout\n", speed);
+  if (wrapped_jumps) fprintf(stderr, "warning: %d position jumps past the end of the song go to its start\n", wrapped_jumps);
+  if (dropped_effects) fprintf(stderr, "warning: %d unsupported effects dropped\n", dropped_effects);
+  if (dropped_notes) fprintf(stderr, "warning: %d notes without an instrument dropped\n", dropped_notes);
+  if (dropped_channel_notes) fprintf(stderr, "warning: %d notes on channels that were not imported\n", dropped_channel_notes);
+  return 0;
+}
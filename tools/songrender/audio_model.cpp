@@ -0,0 +1,188 @@
+//
+// Software model of audio.v / pdm_dac.v.
+//
+// Every register below is updated the way the Verilog non-blocking
+// assignments update it: clock() reads the values from before the edge and
+// computes the values after it.  Widths are masked explicitly so that
+// wrap-around behaves exactly like the hardware.
+//
+#include "audio_model.h"
+
+#include <string.h>
+
+static const uint32_t LFSR_SEED = 0x3724ab;   // 23'b01101110010010000101011
+
+static const uint32_t STATE_IDLE = 0x80;       // 8'b10000000
+
+static const int FILTER_FRACTION_BITS = 10;
+static const int FILTER_BITS = 12 + 2 + FILTER_FRACTION_BITS + 3;
+
+static const int REG_FREQ = 0;
+static const int REG_PULSEWIDTH = 1;
+static const int REG_WAVEPARAMS = 2;
+static const int REG_VOLUME = 3;
+
+static inline uint32_t bit(uint32_t v, int n) { return (v >> n) & 1; }
+
+// filter_saturate() in audio.v: clamp a wide intermediate to FILTER_BITS
+static int32_t filter_saturate(int64_t v) {
+  const int64_t max = (1ll << (FILTER_BITS-1)) - 1;
+  if (v > max) return (int32_t)max;
+  if (v < -max - 1) return (int32_t)(-max - 1);
+  return (int32_t)v;
+}
+
+AudioModel::AudioModel() {
+  // iCE40 registers and block RAM power up as zero
+  memset(config_register_bank, 0, sizeof(config_register_bank));
+  filter_cutoff = filter_resonance = filter_route = filter_mode = 0;
+  memset(accumulator, 0, sizeof(accumulator));
+  memset(prev_accumulator, 0, sizeof(prev_accumulator));
+  memset(lfsr, 0, sizeof(lfsr));
+  divider_counter = 0;
+  ringmod_bit = 0;
+  voice_pipeline_state = 0;
+  voice_num = 0;
+  prev_aclk = 0;
+  tmp_mixed_voices = 0;
+  tmp_filter_input = 0;
+  filter_lp = filter_bp = filter_hp = 0;
+  mixed_voices = 0;
+  latched = false;
+  dac_accumulator = 0;
+
+  reset();
+}
+
+void AudioModel::reset() {
+  voice_num = 0;
+  voice_pipeline_state = STATE_IDLE;
+  for (int v = 0; v < NUM_VOICES; v++) lfsr[v] = LFSR_SEED;
+  filter_cutoff = filter_resonance = filter_route = filter_mode = 0;
+  filter_lp = filter_bp = filter_hp = 0;
+}
+
+void AudioModel::write(uint32_t reg, uint32_t value) {
+  if (reg & 16) {
+    filter_cutoff = value & 0x7f;
+    filter_resonance = (value >> 8) & 0xf;
+    filter_route = (value >> 16) & 0xf;
+    filter_mode = (value >> 24) & 0x7;
+  } else {
+    config_register_bank[reg & 15] = value;
+  }
+}
+
+// hp = in - lp - q*bp, with q = (16 - resonance) / 8
+static int32_t filter_highpass(int32_t in, int32_t lp, int32_t bp, uint32_t resonance) {
+  int64_t damped_bp_x8 = (int64_t)bp * (16 - resonance);
+  return filter_saturate((int64_t)in - lp - (damped_bp_x8 >> 3));
+}
+
+// f*x, with f = (8 + cutoff[2:0]) * 2^(cutoff[6:3] - 16)
+int64_t AudioModel::filter_scale(int32_t x) const {
+  uint32_t octave = (filter_cutoff >> 3) > 9 ? 9 : (filter_cutoff >> 3);
+  return ((int64_t)x * (8 + (filter_cutoff & 7))) >> (16 - octave);
+}
+
+void AudioModel::voice_step() {
+  uint32_t aclk = bit(divider_counter, 27);
+  uint32_t state = voice_pipeline_state;
+  uint32_t next_state = STATE_IDLE;
+
+  if (state & 0x0f) {
+    uint32_t v = voice_num;
+    uint32_t reg_index = v << 2;
+
+    uint32_t acc = accumulator[v];
+    uint32_t params = config_register_bank[reg_index+REG_WAVEPARAMS];
+    uint32_t freq = config_register_bank[reg_index+REG_FREQ] & 0xffffff;
+    uint32_t pulse_width = config_register_bank[reg_index+REG_PULSEWIDTH] & 0xfff;
+    int32_t volume = config_register_bank[reg_index+REG_VOLUME] & 0xff;
+
+    // ringmod_bit is only 4 bits wide, so indices 4 and 8 fall off the end
+    // (writes are dropped, reads are undefined - modelled as zero)
+    uint32_t sync_source = (v == 0) ? 3 : v - 1;
+    uint32_t ringmod_index = 1u << sync_source;
+    uint32_t ringmod_source = ringmod_index < 4 ? bit(ringmod_bit, ringmod_index) : 0;
+    uint32_t ringmod_enable = bit(params, 24);
+
+    uint32_t invert = ringmod_enable ? ringmod_source : bit(acc, 23);
+    uint32_t triangle = (acc >> 11) & 0xfff;
+    if (invert) triangle = ~triangle & 0xfff;
+    uint32_t sawtooth = (acc >> 12) & 0xfff;
+    uint32_t l = lfsr[v];
+    uint32_t noise = (bit(l, 22) << 11) | (bit(l, 20) << 10) | (bit(l, 16) << 9) | (bit(l, 13) << 8)
+                   | (bit(l, 11) << 7) | (bit(l, 7) << 6) | (bit(l, 4) << 5) | (bit(l, 2) << 4);
+    uint32_t pulse = (((acc >> 12) & 0xfff) <= pulse_width) ? 0xfff : 0;
+
+    uint32_t wave = 0xfff;
+    if (bit(params, 19)) wave &= noise;
+    if (bit(params, 18)) wave &= pulse;
+    if (bit(params, 17)) wave &= sawtooth;
+    if (bit(params, 16)) wave &= triangle;
+
+    int32_t unscaled = sign_extend(0x800 ^ wave, SAMPLE_BITS);
+    int32_t scaled = (unscaled * volume) >> 8;
+
+    if (bit(acc, 19) && !bit(prev_accumulator[v], 19))
+      lfsr[v] = ((l << 1) | (bit(l, 22) ^ bit(l, 17))) & 0x7fffff;
+    prev_accumulator[v] = acc;
+    accumulator[v] = (acc + freq) & 0xffffff;
+
+    uint32_t ringmod_write_index = 1u << v;
+    if (ringmod_write_index < 4)
+      ringmod_bit = (ringmod_bit & ~(1u << ringmod_write_index)) | (bit(acc, 23) << ringmod_write_index);
+
+    if (bit(filter_route, v))
+      tmp_filter_input = (tmp_filter_input + ((uint32_t)scaled & 0x3fff)) & 0x3fff;
+    else
+      tmp_mixed_voices = (tmp_mixed_voices + ((uint32_t)scaled & 0x3fff)) & 0x3fff;
+
+    voice_num = (v + 1) & 3;
+    next_state = state << 1;
+  } else if (state & 0x10) {
+    // latch the mix (with last sample's filter outputs), then lp += f*bp
+    int64_t out = 0;
+    if (filter_mode & 1) out += filter_lp;
+    if (filter_mode & 2) out += filter_bp;
+    if (filter_mode & 4) out += filter_hp;
+    int64_t mix = (out >> FILTER_FRACTION_BITS) + sign_extend(tmp_mixed_voices, SAMPLE_BITS+2);
+    if (mix > 0x1fff) mix = 0x1fff;
+    if (mix < -0x2000) mix = -0x2000;
+    mixed_voices = (uint32_t)mix & 0x3fff;
+    latched = true;
+
+    filter_lp = filter_saturate(filter_lp + filter_scale(filter_bp));
+    next_state = state << 1;
+  } else if (state & 0x20) {
+    int32_t in = sign_extend(tmp_filter_input, SAMPLE_BITS+2) * (1 << FILTER_FRACTION_BITS);
+    filter_hp = filter_highpass(in, filter_lp, filter_bp, filter_resonance);
+    next_state = state << 1;
+  } else if (state & 0x40) {
+    filter_bp = filter_saturate(filter_bp + filter_scale(filter_hp));
+  } else if (state & 0x80) {
+    if (!prev_aclk && aclk) {
+      next_state = 0x01;
+      tmp_mixed_voices = 0;
+      tmp_filter_input = 0;
+      voice_num = 0;
+    }
+  }
+
+  voice_pipeline_state = next_state;
+  prev_aclk = aclk;
+}
+
+int AudioModel::clock() {
+  uint32_t dac_din = mixed_voices;   // value before this edge
+
+  latched = false;
+  voice_step();
+
+  divider_counter = (divider_counter + (1u << 24)) & 0xfffffff;
+
+  uint32_t unsigned_din = (dac_din ^ 0x2000) & 0x3fff;
+  dac_accumulator = (dac_accumulator & 0x3fff) + unsigned_din;
+  return bit(dac_accumulator, 14);
+}
@@ -0,0 +1,71 @@
+//
+// Cycle/bit accurate software model of hdl/picosoc/audio/audio.v and the
+// pdm_dac it drives.  One call to clock() is one edge of the 16MHz system
+// clock.
+//
+#ifndef __AUDIO_MODEL_H__
+#define __AUDIO_MODEL_H__
+
+#include <stdint.h>
+
+class AudioModel {
+public:
+  static const int SAMPLE_BITS = 12;
+  static const int NUM_VOICES = 4;
+  static const uint32_t CLK_HZ = 16000000;
+
+  AudioModel();
+
+  // equivalent of resetn being held low
+  void reset();
+
+  // 32 bit store to config register "reg" (0..15), ie. 0x0400_0000 + reg*4,
+  // or to the filter register (16)
+  void write(uint32_t reg, uint32_t value);
+
+  // advance one system clock; returns the PDM output pin
+  int clock();
+
+  // the current (latched) 14 bit mixer output, sign extended
+  int32_t mixed() const { return sign_extend(mixed_voices, SAMPLE_BITS+2); }
+
+  // true on the clock where a new mixed sample was latched
+  bool sample_latched() const { return latched; }
+
+private:
+  static int32_t sign_extend(uint32_t v, int bits) {
+    return (int32_t)(v << (32-bits)) >> (32-bits);
+  }
+
+  void voice_step();
+  int64_t filter_scale(int32_t x) const;
+
+  uint32_t config_register_bank[16];
+
+  // filter register
+  uint32_t filter_cutoff;                  // 7 bits
+  uint32_t filter_resonance;               // 4 bits
+  uint32_t filter_route;                   // 4 bits
+  uint32_t filter_mode;                    // 3 bits
+
+  // clock_divider #(16)
+  uint32_t divider_counter;   // 28 bits
+
+  uint32_t accumulator[NUM_VOICES];        // 24 bits
+  uint32_t prev_accumulator[NUM_VOICES];   // 24 bits
+  uint32_t lfsr[NUM_VOICES];               // 23 bits
+  uint32_t ringmod_bit;                    // 4 bits
+  uint32_t voice_pipeline_state;           // 8 bits, one-hot
+  uint32_t voice_num;                      // 2 bits
+  uint32_t prev_aclk;
+  uint32_t tmp_mixed_voices;               // 14 bits
+  uint32_t tmp_filter_input;               // 14 bits
+  int32_t filter_lp, filter_bp, filter_hp; // FILTER_BITS, signed
+  uint32_t mixed_voices;                   // 14 bits
+  bool latched;
+
+  // pdm_dac #(14)
+  uint32_t dac_accumulator;                // 15 bits
+};
+
+#endif
@@ -0,0 +1,278 @@
+//
+// songrender - play a song_t through the real songplayer.c and a model of
+// the audio peripheral, on the host.
+//
+//  - renders the PDM output (low-pass filtered) to a .wav file
+//  - reports how much work each 50Hz songplayer_tick() does: audio register
+//    writes, and the host's cost of the tick, which only compares runs on the
+//    same machine (the firmware's RV32 cost is tools/xiporder's to measure)
+//  - prints a digest of the mixer output, used as a golden reference
+//    ("make check") when changing songplayer or the song data
+//  - prints what the audio capture tap would record, in the format of
+//    audio_capture_dump(), to compare against a capture from a board
+//
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <vector>
+#include <linux/perf_event.h>
+
+#include "audio_model.h"
+
+extern "C" {
+#include <songplayer/songplayer.h>
+
+extern const struct song_t song_pacman;
+extern const struct song_t song_petergun;
+}
+
+static const struct {
+  const char *name;
+  const struct song_t *song;
+} songs[] = {
+  { "pacman", &song_pacman },
+  { "petergun", &song_petergun },
+};
+
+static const uint32_t TICK_HZ = 50;
+static const uint32_t CLOCKS_PER_TICK = AudioModel::CLK_HZ / TICK_HZ;
+static const int MAX_EFFECTS = 64;
+static const uint32_t CAPTURE_SIZE = 512;
+
+static AudioModel audio;
+static uint32_t register_writes;
+static bool capture_waiting;   // AUDIO_CAPTURE_ON_WRITE
+
+// songplayer.c is built with HOST_AUDIO_MODEL, so audio_write() ends up here
+extern "C" void audio_model_write(uint32_t reg, uint32_t value) {
+  register_writes++;
+  if (reg < 16) capture_waiting = false;
+  audio.write(reg, value);
+}
+
+// Counts retired (host) instructions around each tick if the kernel lets us,
+// otherwise falls back to thread CPU time.  Either is the x86 (or whatever
+// the host is) cost of the C code, not picorv32 clocks.
+class WorkCounter {
+public:
+  WorkCounter() {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+  ~WorkCounter() { if (fd >= 0) close(fd); }
+
+  const char *unit() const { return fd >= 0 ? "host insns" : "host ns"; }
+
+  uint64_t now() const {
+    if (fd >= 0) {
+      uint64_t count = 0;
+      if (read(fd, &count, sizeof(count)) == sizeof(count)) return count;
+      return 0;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+  }
+
+private:
+  int fd;
+};
+
+struct Stat {
+  uint64_t min, max, total;
+  uint32_t count, max_tick;
+
+  Stat() : min(UINT64_MAX), max(0), total(0), count(0), max_tick(0) {}
+
+  void add(uint64_t v, uint32_t tick) {
+    if (v < min) min = v;
+    if (v > max) { max = v; max_tick = tick; }
+    total += v;
+    count++;
+  }
+
+  void print(const char *label) const {
+    if (!count) return;
+    printf("%-22s min %6llu  avg %8.1f  max %6llu (tick %u)\n", label,
+           (unsigned long long)min, (double)total / count,
+           (unsigned long long)max, max_tick);
+  }
+};
+
+static void put_le(FILE *f, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) fputc((v >> (8*i)) & 0xff, f);
+}
+
+static void write_wav_header(FILE *f, uint32_t rate, uint32_t samples) {
+  uint32_t data_bytes = samples * 2;
+  fwrite("RIFF", 1, 4, f);
+  put_le(f, 36 + data_bytes, 4);
+  fwrite("WAVEfmt ", 1, 8, f);
+  put_le(f, 16, 4);          // fmt chunk size
+  put_le(f, 1, 2);           // PCM
+  put_le(f, 1, 2);           // mono
+  put_le(f, rate, 4);
+  put_le(f, rate * 2, 4);    // byte rate
+  put_le(f, 2, 2);           // block align
+  put_le(f, 16, 2);          // bits per sample
+  fwrite("data", 1, 4, f);
+  put_le(f, data_bytes, 4);
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  -s song        song to play (pacman, petergun)\n"
+    "  -t ticks       number of 50Hz ticks to render (default: one pass of the song)\n"
+    "  -o file.wav    write the filtered PDM output as 16 bit mono PCM\n"
+    "  -r rate        .wav sample rate (default 44100)\n"
+    "  -f tick:bar    trigger bar as a sound effect at the given tick (repeatable)\n"
+    "  -c n           print a one-shot capture (1 in n samples) starting at the first\n"
+    "                 voice register write, like audio_capture_dump()\n"
+    "  -v             print one line per tick\n", prog);
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  const char *song_name = "pacman";
+  const char *wav_name = NULL;
+  uint32_t ticks = 0;
+  uint32_t rate = 44100;
+  bool verbose = false;
+  uint32_t effect_tick[MAX_EFFECTS], effect_bar[MAX_EFFECTS];
+  int num_effects = 0;
+  uint32_t capture_decimation = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "s:t:o:r:f:c:v")) != -1) {
+    switch (opt) {
+      case 's': song_name = optarg; break;
+      case 't': ticks = strtoul(optarg, NULL, 0); break;
+      case 'o': wav_name = optarg; break;
+      case 'r': rate = strtoul(optarg, NULL, 0); break;
+      case 'f':
+        if (num_effects == MAX_EFFECTS ||
+            sscanf(optarg, "%u:%u", &effect_tick[num_effects], &effect_bar[num_effects]) != 2)
+          usage(argv[0]);
+        num_effects++;
+        break;
+      case 'c': capture_decimation = strtoul(optarg, NULL, 0); break;
+      case 'v': verbose = true; break;
+      default: usage(argv[0]);
+    }
+  }
+  if (rate == 0 || rate > AudioModel::CLK_HZ) usage(argv[0]);
+
+  const struct song_t *song = NULL;
+  for (size_t i = 0; i < sizeof(songs)/sizeof(songs[0]); i++)
+    if (!strcmp(songs[i].name, song_name)) song = songs[i].song;
+  if (!song) {
+    fprintf(stderr, "unknown song '%s'\n", song_name);
+    return 1;
+  }
+  if (!ticks) ticks = song->song_length * song->rows_per_bar * song->ticks_per_div;
+
+  FILE *wav = NULL;
+  uint64_t total_clocks = (uint64_t)ticks * CLOCKS_PER_TICK;
+  uint32_t wav_samples = (uint32_t)(total_clocks * rate / AudioModel::CLK_HZ);
+  if (wav_name) {
+    wav = fopen(wav_name, "wb");
+    if (!wav) {
+      perror(wav_name);
+      return 1;
+    }
+    write_wav_header(wav, rate, wav_samples);
+  }
+
+  WorkCounter work;
+  Stat writes_stat, work_stat;
+
+  // FNV-1a over every latched mixer sample
+  uint64_t digest = 0xcbf29ce484222325ull;
+
+  uint64_t clk = 0;
+  uint32_t sample = 0;
+  uint64_t next_sample_clk = AudioModel::CLK_HZ / rate;
+  uint32_t pdm_ones = 0, pdm_count = 0;
+
+  std::vector<uint32_t> capture;
+  uint32_t capture_count = 0;
+  capture_waiting = capture_decimation != 0;
+
+  songplayer_init(song);
+  songplayer_start(0);
+
+  for (uint32_t tick = 0; tick < ticks; tick++) {
+    for (int i = 0; i < num_effects; i++)
+      if (effect_tick[i] == tick) songplayer_trigger_effect(effect_bar[i]);
+
+    register_writes = 0;
+    uint64_t start = work.now();
+    songplayer_tick();
+    uint64_t cost = work.now() - start;
+
+    writes_stat.add(register_writes, tick);
+    work_stat.add(cost, tick);
+    if (verbose)
+      printf("tick %5u  writes %3u  %s %llu\n", tick, register_writes, work.unit(),
+             (unsigned long long)cost);
+
+    for (uint32_t c = 0; c < CLOCKS_PER_TICK; c++, clk++) {
+      pdm_ones += audio.clock();
+      pdm_count++;
+
+      if (audio.sample_latched()) {
+        uint32_t m = (uint32_t)audio.mixed() & 0x3fff;
+        digest = (digest ^ (m & 0xff)) * 0x100000001b3ull;
+        digest = (digest ^ (m >> 8)) * 0x100000001b3ull;
+
+        if (capture_decimation && !capture_waiting && capture.size() < CAPTURE_SIZE) {
+          if (capture_count == 0) capture.push_back(m & 0x2000 ? m | 0xc000 : m);
+          capture_count = capture_count + 1 == capture_decimation ? 0 : capture_count + 1;
+        }
+      }
+
+      // boxcar average of the PDM stream over each output sample period
+      if (wav && clk + 1 == next_sample_clk) {
+        if (sample < wav_samples) {
+          int32_t pcm = (int32_t)((2.0 * pdm_ones / pdm_count - 1.0) * 32767.0);
+          put_le(wav, (uint32_t)pcm & 0xffff, 2);
+        }
+        sample++;
+        pdm_ones = pdm_count = 0;
+        next_sample_clk = (uint64_t)(sample + 1) * AudioModel::CLK_HZ / rate;
+      }
+    }
+  }
+
+  if (wav) fclose(wav);
+
+  printf("song %s: %u ticks (%.2f s)\n", song_name, ticks, (double)ticks / TICK_HZ);
+  writes_stat.print("register writes/tick:");
+  char label[32];
+  snprintf(label, sizeof(label), "%s/tick:", work.unit());
+  work_stat.print(label);
+  printf("  (host cost: compare runs on this machine only, not RV32 clocks)\n");
+  printf("digest %016llx\n", (unsigned long long)digest);
+
+  if (capture_decimation) {
+    uint32_t status = capture.size() == CAPTURE_SIZE ? 2 : (capture_waiting ? 4 : 1);
+    printf("capture %04X %04X %08X\n", 0, (unsigned)capture.size(),
+           (unsigned)(((capture.size() & (CAPTURE_SIZE-1)) << 16) | status));
+    for (size_t i = 0; i < capture.size(); i++)
+      printf("%04X%s", capture[i], (i & 15) == 15 ? "\n" : " ");
+    if (capture.size() & 15) printf("\n");
+    printf("end\n");
+  }
+  return 0;
+}
@@ -0,0 +1,889 @@
+//
+// xiporder - profile-guided function ordering for code run from SPI flash
+//
+// Runs a firmware.elf on a host model of picosoc (RV32I, picorv32 IRQs and
+// timer, 4K RAM, memory mapped flash, the timer peripheral) and counts the flash read commands
+// spimemio would issue: every fetch or load from flash that isn't the word
+// after the previous one.  Jumps between functions that cause a new command
+// are the edges of a call graph; functions joined by the heaviest edges are
+// chained together (Pettis & Hansen) and the chains written out, hottest
+// first, as a linker script fragment for firmware/sections.lds.
+//
+// The program is then run again with fetches mapped to where the functions
+// would be with that order, to report the command count before and after.
+//
+// With -m it instead reports how much stack and RAM the run used, from what
+// is left of the paint firmware/start.S puts on them, and warns if that
+// would not fit.
+//
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+static const uint32_t RAM_BYTES = 4096;
+static const uint32_t FLASH_START = 0x00001000;   // below is RAM
+static const uint32_t FLASH_END = 0x02000000;
+static const uint32_t PROGADDR_RESET = 0x00050000;
+static const uint32_t PROGADDR_IRQ = 0x00050010;
+static const uint32_t STACKADDR = 1024;
+
+// the RAM map, and the paint on unused RAM (libraries/ramcheck/ramcheck.h)
+static const uint32_t RAM_PAINT = 0xa5a5a5a5;
+static const uint32_t RAM_IRQ_STACK = 0x080;
+static const uint32_t RAM_MAIN_STACK = 0x180;
+static const uint32_t RAM_DATA = 0x400;
+
+static const int IRQ_TIMER = 0;
+static const int IRQ_EBREAK = 1;
+static const int IRQ_5 = 5;   // hdl/picosoc/irqctl: timer channels
+
+// hdl/picosoc/timer (-Dtimer)
+static const uint32_t TIMER_BASE = 0x0c000000;
+static const int TIMER_CHANNELS = 4;
+
+struct Function {
+  std::string name;
+  uint32_t addr, size;
+  uint64_t fetches;
+  uint32_t new_addr;
+};
+
+struct Options {
+  uint64_t max_insns;
+  uint32_t max_frames;
+  uint32_t flash_seq_clocks;
+  uint32_t flash_jump_clocks;
+  uint32_t iomem_value;
+  uint32_t clk_mhz;      // SYS_CLK_MHZ, for the timer's microseconds
+  bool uart;
+  bool barrel_shifter;   // picorv32 BARREL_SHIFTER
+};
+
+// ---------------------------------------------------------------- ELF
+
+class Elf {
+public:
+  std::vector<uint8_t> flash;          // FLASH_START .. FLASH_START + size
+  std::vector<Function> functions;     // in flash, sorted by address
+  uint32_t heap_start = 0;             // _heap_start: the end of .bss in RAM
+
+  bool load(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+      perror(path);
+      return false;
+    }
+    std::vector<uint8_t> file;
+    uint8_t buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) file.insert(file.end(), buffer, buffer + n);
+    fclose(f);
+    data = &file;
+
+    if (file.size() < 52 || memcmp(&file[0], "\177ELF", 4) || file[4] != 1 || file[5] != 1 ||
+        u16(18) != 243) {
+      fprintf(stderr, "%s: not a 32 bit little endian RISC-V ELF file\n", path);
+      return false;
+    }
+
+    uint32_t phoff = u32(28), shoff = u32(32);
+    uint32_t phentsize = u16(42), phnum = u16(44);
+    uint32_t shentsize = u16(46), shnum = u16(48);
+
+    // loadable segments, at their load (flash) address
+    for (uint32_t i = 0; i < phnum; i++) {
+      uint32_t ph = phoff + i * phentsize;
+      if (u32(ph) != 1 || u32(ph + 16) == 0) continue;   // PT_LOAD with file contents
+      uint32_t offset = u32(ph + 4), paddr = u32(ph + 12), filesz = u32(ph + 16);
+      if (paddr < FLASH_START || paddr + filesz > FLASH_END) continue;
+      if (flash.size() < paddr + filesz - FLASH_START) flash.resize(paddr + filesz - FLASH_START, 0xff);
+      memcpy(&flash[paddr - FLASH_START], &file[offset], filesz);
+    }
+
+    // function symbols in flash
+    for (uint32_t i = 0; i < shnum; i++) {
+      uint32_t sh = shoff + i * shentsize;
+      if (u32(sh + 4) != 2) continue;   // SHT_SYMTAB
+      uint32_t offset = u32(sh + 16), size = u32(sh + 20), link = u32(sh + 24);
+      uint32_t strtab = u32(shoff + link * shentsize + 16);
+      for (uint32_t s = offset; s + 16 <= offset + size; s += 16) {
+        uint32_t value = u32(s + 4), sym_size = u32(s + 8);
+        uint8_t type = file[s + 12] & 15;
+        if (!strcmp((const char *)&file[strtab + u32(s)], "_heap_start")) heap_start = value;
+        if (type != 2 || sym_size == 0) continue;   // STT_FUNC
+        if (value < FLASH_START || value >= FLASH_END) continue;
+        Function fn;
+        fn.name = (const char *)&file[strtab + u32(s)];
+        fn.addr = value;
+        fn.size = sym_size;
+        fn.fetches = 0;
+        fn.new_addr = value;
+        functions.push_back(fn);
+      }
+    }
+    std::sort(functions.begin(), functions.end(),
+              [](const Function &a, const Function &b) { return a.addr < b.addr; });
+    if (flash.empty() || functions.empty()) {
+      fprintf(stderr, "%s: no code or no function symbols in flash\n", path);
+      return false;
+    }
+    return true;
+  }
+
+  // index of the function containing addr, or -1
+  int find(uint32_t addr) const {
+    size_t lo = 0, hi = functions.size();
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (functions[mid].addr <= addr) lo = mid + 1; else hi = mid;
+    }
+    if (lo == 0) return -1;
+    const Function &fn = functions[lo - 1];
+    return addr < fn.addr + fn.size ? (int)(lo - 1) : -1;
+  }
+
+private:
+  const std::vector<uint8_t> *data;
+  uint32_t u16(uint32_t o) const { return (*data)[o] | ((*data)[o + 1] << 8); }
+  uint32_t u32(uint32_t o) const { return u16(o) | (u16(o + 2) << 16); }
+};
+
+// ---------------------------------------------------------------- RV32C
+
+static uint32_t r_type(uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) {
+  return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static uint32_t i_type(int32_t imm, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) {
+  return ((uint32_t)imm << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static uint32_t s_type(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t op) {
+  return (((uint32_t)imm >> 5 & 0x7f) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) |
+         ((imm & 31) << 7) | op;
+}
+
+static uint32_t b_type(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3) {
+  uint32_t u = imm;
+  return ((u >> 12 & 1) << 31) | ((u >> 5 & 0x3f) << 25) | (rs2 << 20) | (rs1 << 15) |
+         (f3 << 12) | ((u >> 1 & 15) << 8) | ((u >> 11 & 1) << 7) | 0x63;
+}
+
+static uint32_t j_type(int32_t imm, uint32_t rd) {
+  uint32_t u = imm;
+  return ((u >> 20 & 1) << 31) | ((u >> 1 & 0x3ff) << 21) | ((u >> 11 & 1) << 20) |
+         ((u >> 12 & 0xff) << 12) | (rd << 7) | 0x6f;
+}
+
+static int32_t sign_extend(uint32_t v, int bits) {
+  return (int32_t)(v << (32 - bits)) >> (32 - bits);
+}
+
+// the RV32I instruction a compressed one stands for (0: illegal)
+static uint32_t expand_compressed(uint32_t c) {
+  uint32_t op = c & 3, f3 = c >> 13 & 7;
+  uint32_t rd = c >> 7 & 31, rs2 = c >> 2 & 31;
+  uint32_t rd_ = 8 + (c >> 2 & 7), rs1_ = 8 + (c >> 7 & 7);   // x8-x15 forms
+
+  if (op == 0) {
+    uint32_t lw_imm = (c >> 6 & 1) << 2 | (c >> 10 & 7) << 3 | (c >> 5 & 1) << 6;
+    switch (f3) {
+      case 0: {   // c.addi4spn
+        uint32_t imm = (c >> 6 & 1) << 2 | (c >> 5 & 1) << 3 | (c >> 11 & 3) << 4 | (c >> 7 & 15) << 6;
+        return imm ? i_type(imm, 2, 0, rd_, 0x13) : 0;
+      }
+      case 2: return i_type(lw_imm, rs1_, 2, rd_, 0x03);      // c.lw
+      case 6: return s_type(lw_imm, rd_, rs1_, 2, 0x23);      // c.sw
+    }
+    return 0;
+  }
+
+  if (op == 1) {
+    int32_t imm6 = sign_extend((c >> 12 & 1) << 5 | (c >> 2 & 31), 6);
+    int32_t j_imm = sign_extend((c >> 3 & 7) << 1 | (c >> 11 & 1) << 4 | (c >> 2 & 1) << 5 |
+                                (c >> 7 & 1) << 6 | (c >> 6 & 1) << 7 | (c >> 9 & 3) << 8 |
+                                (c >> 8 & 1) << 10 | (c >> 12 & 1) << 11, 12);
+    int32_t b_imm = sign_extend((c >> 3 & 3) << 1 | (c >> 10 & 3) << 3 | (c >> 2 & 1) << 5 |
+                                (c >> 5 & 3) << 6 | (c >> 12 & 1) << 8, 9);
+    switch (f3) {
+      case 0: return i_type(imm6, rd, 0, rd, 0x13);           // c.addi, c.nop
+      case 1: return j_type(j_imm, 1);                        // c.jal
+      case 2: return i_type(imm6, 0, 0, rd, 0x13);            // c.li
+      case 3:
+        if (rd == 2) {                                        // c.addi16sp
+          int32_t imm = sign_extend((c >> 6 & 1) << 4 | (c >> 2 & 1) << 5 | (c >> 5 & 1) << 6 |
+                                    (c >> 3 & 3) << 7 | (c >> 12 & 1) << 9, 10);
+          return i_type(imm, 2, 0, 2, 0x13);
+        }
+        return ((uint32_t)imm6 << 12 & 0xfffff000) | (rd << 7) | 0x37;   // c.lui
+      case 4: {
+        uint32_t shamt = c >> 2 & 31;
+        switch (c >> 10 & 3) {
+          case 0: return r_type(0x00, shamt, rs1_, 5, rs1_, 0x13);  // c.srli
+          case 1: return r_type(0x20, shamt, rs1_, 5, rs1_, 0x13);  // c.srai
+          case 2: return i_type(imm6, rs1_, 7, rs1_, 0x13);         // c.andi
+        }
+        uint32_t rs2_ = 8 + (c >> 2 & 7);
+        switch (c >> 5 & 3) {
+          case 0: return r_type(0x20, rs2_, rs1_, 0, rs1_, 0x33);   // c.sub
+          case 1: return r_type(0x00, rs2_, rs1_, 4, rs1_, 0x33);   // c.xor
+          case 2: return r_type(0x00, rs2_, rs1_, 6, rs1_, 0x33);   // c.or
+          case 3: return r_type(0x00, rs2_, rs1_, 7, rs1_, 0x33);   // c.and
+        }
+        return 0;
+      }
+      case 5: return j_type(j_imm, 0);                        // c.j
+      case 6: return b_type(b_imm, 0, rs1_, 0);               // c.beqz
+      case 7: return b_type(b_imm, 0, rs1_, 1);               // c.bnez
+    }
+    return 0;
+  }
+
+  if (op == 2) {
+    switch (f3) {
+      case 0: return r_type(0, c >> 2 & 31, rd, 1, rd, 0x13);  // c.slli
+      case 2: {                                               // c.lwsp
+        uint32_t imm = (c >> 4 & 7) << 2 | (c >> 12 & 1) << 5 | (c >> 2 & 3) << 6;
+        return i_type(imm, 2, 2, rd, 0x03);
+      }
+      case 4:
+        if (!(c >> 12 & 1)) {
+          if (!rs2) return i_type(0, rd, 0, 0, 0x67);         // c.jr
+          return r_type(0, rs2, 0, 0, rd, 0x33);              // c.mv
+        }
+        if (!rd && !rs2) return 0x00100073;                   // c.ebreak
+        if (!rs2) return i_type(0, rd, 0, 1, 0x67);           // c.jalr
+        return r_type(0, rs2, rd, 0, rd, 0x33);               // c.add
+      case 6: {                                               // c.swsp
+        uint32_t imm = (c >> 9 & 15) << 2 | (c >> 7 & 3) << 6;
+        return s_type(imm, rs2, 2, 2, 0x23);
+      }
+    }
+  }
+  return 0;
+}
+
+// ---------------------------------------------------------------- SoC model
+
+class Soc {
+public:
+  Soc(const Elf &elf, const Options &opt, bool remap)
+      : elf(elf), opt(opt), remap(remap), ram(RAM_BYTES, 0) {
+    memset(x, 0, sizeof(x));
+    memset(q, 0, sizeof(q));
+    x[2] = STACKADDR;
+    pc = PROGADDR_RESET;
+    irq_mask = ~0u;
+    irq_pending = 0;
+    irq_active = false;
+    timer = 0;
+    memset(channel_compare, 0, sizeof(channel_compare));
+    memset(channel_period, 0, sizeof(channel_period));
+    channel_enable = channel_status = 0;
+    spictrl = 0x80080000;
+    clocks = insns = frames = flash_commands = irq_clocks = 0;
+    last_flash = ~0u;
+    last_fn = -1;
+    cached_fn = -1;
+    halted = false;
+  }
+
+  const Elf &elf;
+  const Options &opt;
+  bool remap;
+
+  uint64_t clocks, insns, flash_commands;
+  uint64_t irq_clocks;   // spent in interrupt handlers
+  uint32_t frames;
+  bool halted;
+  std::vector<uint64_t> fetches;                  // per function
+  std::map<std::pair<int, int>, uint64_t> edges;  // jumps between functions costing a command
+
+  uint32_t ram_word(uint32_t addr) const {
+    return ram[addr] | ram[addr + 1] << 8 | ram[addr + 2] << 16 | (uint32_t)ram[addr + 3] << 24;
+  }
+
+  void run() {
+    fetches.assign(elf.functions.size(), 0);
+    while (!halted && insns < opt.max_insns && (!opt.max_frames || frames < opt.max_frames))
+      step();
+  }
+
+private:
+  std::vector<uint8_t> ram;
+  uint32_t x[32], q[4], pc;
+  uint32_t irq_mask, irq_pending, timer, spictrl;
+  uint32_t channel_compare[TIMER_CHANNELS], channel_period[TIMER_CHANNELS];
+  uint32_t channel_enable, channel_status;
+  bool irq_active;
+  uint32_t last_flash;
+  int last_fn, cached_fn;
+
+  int function_at(uint32_t addr) {
+    if (cached_fn >= 0) {
+      const Function &fn = elf.functions[cached_fn];
+      if (addr >= fn.addr && addr < fn.addr + fn.size) return cached_fn;
+    }
+    int f = elf.find(addr);
+    if (f >= 0) cached_fn = f;
+    return f;
+  }
+
+  // spimemio: a read that isn't of the word after (or the same as) the last
+  // one starts a new read command
+  uint32_t flash_access(uint32_t addr, bool fetch) {
+    uint32_t where = addr;
+    int f = -1;
+    if (fetch) {
+      f = function_at(addr);
+      if (f >= 0) {
+        fetches[f]++;
+        if (remap) where = addr - elf.functions[f].addr + elf.functions[f].new_addr;
+      }
+    }
+    where &= ~3u;
+    uint32_t cost;
+    if (where == last_flash + 4 || where == last_flash) {
+      cost = opt.flash_seq_clocks;
+    } else {
+      cost = opt.flash_jump_clocks;
+      flash_commands++;
+      if (fetch && f >= 0 && last_fn >= 0 && f != last_fn)
+        edges[std::make_pair(std::min(f, last_fn), std::max(f, last_fn))]++;
+    }
+    last_flash = where;
+    if (fetch) last_fn = f;
+    return cost;
+  }
+
+  uint32_t load(uint32_t addr, int bytes, bool fetch = false) {
+    uint32_t value = 0;
+    if (addr < RAM_BYTES) {
+      tick(1);
+      for (int i = 0; i < bytes; i++) value |= ram[(addr + i) & (RAM_BYTES - 1)] << (8 * i);
+    } else if (addr < FLASH_END) {
+      tick(flash_access(addr, fetch));
+      uint32_t o = addr - FLASH_START;
+      for (int i = 0; i < bytes; i++)
+        value |= (o + i < elf.flash.size() ? elf.flash[o + i] : 0xff) << (8 * i);
+    } else if (addr == 0x02000000) {
+      value = spictrl;
+    } else if (addr == 0x02000008) {
+      value = ~0u;   // simpleuart: nothing received
+    } else if (addr == 0x0200000c) {
+      value = 0x110;   // simpleuart: all sent, room for 16 (bytes go out at once)
+    } else if (addr >= TIMER_BASE && addr < TIMER_BASE + 0x48) {
+      tick(1);
+      value = timer_read(addr - TIMER_BASE);
+    } else if (addr > 0x02ffffff) {
+      tick(1);
+      value = opt.iomem_value;
+    }
+    if (bytes == 1) value &= 0xff;
+    if (bytes == 2) value &= 0xffff;
+    return value;
+  }
+
+  void store(uint32_t addr, uint32_t value, int bytes) {
+    if (addr < RAM_BYTES) {
+      tick(1);
+      for (int i = 0; i < bytes; i++) ram[(addr + i) & (RAM_BYTES - 1)] = value >> (8 * i);
+    } else if (addr == 0x02000000) {
+      spictrl = value;
+    } else if (addr == 0x02000008) {
+      if (opt.uart) fputc(value & 0xff, stderr);
+    } else if (addr >= TIMER_BASE && addr < TIMER_BASE + 0x48) {
+      tick(1);
+      timer_write(addr - TIMER_BASE, value);
+    } else if (addr > 0x02ffffff) {
+      tick(1);
+    }
+  }
+
+  // the timer peripheral's counters run from the model's clock count
+  uint32_t timer_us() const {
+    return clocks / opt.clk_mhz;
+  }
+
+  uint32_t timer_read(uint32_t offset) {
+    if (offset >= 0x40) return channel_enable;
+    if (offset >= 0x10) {
+      int n = (offset - 0x10) >> 3;
+      return offset & 4 ? channel_period[n] : channel_compare[n];
+    }
+    switch (offset) {
+      case 0x00: return clocks;
+      case 0x04: return timer_us();
+      case 0x08: return channel_status;
+      default: return channel_enable;
+    }
+  }
+
+  void timer_write(uint32_t offset, uint32_t value) {
+    uint32_t bits = value & ((1 << TIMER_CHANNELS) - 1);
+    if (offset == 0x40) channel_enable |= bits;
+    else if (offset == 0x44) channel_enable &= ~bits;
+    else if (offset >= 0x10 && offset < 0x40) {
+      int n = (offset - 0x10) >> 3;
+      if (offset & 4) channel_period[n] = value;
+      else channel_compare[n] = value;
+    } else if (offset == 0x08) channel_status &= ~bits;
+    else if (offset == 0x0c) channel_enable = bits;
+  }
+
+  // a channel at or past its compare value fires, through the interrupt
+  // controller, on IRQ 5 (as if irqctl had the timer event enabled)
+  void timer_channels() {
+    uint32_t us = timer_us();
+    for (int n = 0; n < TIMER_CHANNELS; n++) {
+      if (!(channel_enable & (1 << n)) || (int32_t)(us - channel_compare[n]) < 0) continue;
+      channel_status |= 1 << n;
+      irq_pending |= 1 << IRQ_5;
+      if (channel_period[n]) channel_compare[n] += channel_period[n];
+      else channel_enable &= ~(1 << n);
+    }
+  }
+
+  // clocks until the picorv32 timer or a timer channel next raises an
+  // interrupt, or 0 if neither will
+  uint64_t next_wakeup() const {
+    uint64_t wake = timer;
+    uint32_t us = timer_us();
+    for (int n = 0; n < TIMER_CHANNELS; n++) {
+      if (!(channel_enable & (1 << n))) continue;
+      int32_t wait_us = channel_compare[n] - us;
+      uint64_t until = wait_us > 0 ? (uint64_t)wait_us * opt.clk_mhz - clocks % opt.clk_mhz : 1;
+      if (!wake || until < wake) wake = until;
+    }
+    return wake;
+  }
+
+  void tick(uint32_t n) {
+    clocks += n;
+    if (irq_active) irq_clocks += n;
+    if (timer) {
+      if (timer <= n) {
+        timer = 0;
+        irq_pending |= 1 << IRQ_TIMER;
+      } else timer -= n;
+    }
+    if (channel_enable) timer_channels();
+  }
+
+  void raise(int irq) {
+    irq_pending |= 1 << irq;
+  }
+
+  void step() {
+    // picorv32 takes an interrupt between instructions
+    if (!irq_active && (irq_pending & ~irq_mask)) {
+      q[0] = pc;
+      q[1] = irq_pending & ~irq_mask;
+      if (q[1] & (1 << IRQ_TIMER)) frames++;
+      irq_pending &= irq_mask;
+      irq_active = true;
+      pc = PROGADDR_IRQ;
+      tick(2);
+    }
+
+    // picorv32 fetches aligned words; with RV32C an instruction may span two
+    uint32_t insn = load(pc & ~3u, 4, true);
+    if (pc & 2) insn >>= 16;
+    uint32_t next = pc + 4;
+    if ((insn & 3) != 3) {
+      insn = expand_compressed(insn & 0xffff);
+      next = pc + 2;
+    } else if (pc & 2) {
+      insn |= load(pc + 2, 4, true) << 16;
+    }
+    insns++;
+
+    uint32_t opcode = insn & 0x7f, rd = (insn >> 7) & 31, f3 = (insn >> 12) & 7;
+    uint32_t rs1 = x[(insn >> 15) & 31], rs2 = x[(insn >> 20) & 31], f7 = insn >> 25;
+    int32_t imm_i = (int32_t)insn >> 20;
+    int32_t imm_s = ((int32_t)insn >> 25 << 5) | ((insn >> 7) & 31);
+    int32_t imm_b = ((int32_t)insn >> 31 << 12) | ((insn & 0x80) << 4) | ((insn >> 20) & 0x7e0) |
+                    ((insn >> 7) & 0x1e);
+    int32_t imm_j = ((int32_t)insn >> 31 << 20) | (insn & 0xff000) | ((insn >> 9) & 0x800) |
+                    ((insn >> 20) & 0x7fe);
+    uint32_t result = 0;
+    bool write = true;
+    uint32_t cost = 3;
+
+    switch (opcode) {
+      case 0x37: result = insn & 0xfffff000; break;                      // lui
+      case 0x17: result = pc + (insn & 0xfffff000); break;               // auipc
+      case 0x6f: result = next; next = pc + imm_j; break;                // jal
+      case 0x67: result = next; next = (rs1 + imm_i) & ~1u; cost = 6; break;  // jalr
+      case 0x63: {                                                       // branches
+        bool taken = false;
+        switch (f3) {
+          case 0: taken = rs1 == rs2; break;
+          case 1: taken = rs1 != rs2; break;
+          case 4: taken = (int32_t)rs1 < (int32_t)rs2; break;
+          case 5: taken = (int32_t)rs1 >= (int32_t)rs2; break;
+          case 6: taken = rs1 < rs2; break;
+          case 7: taken = rs1 >= rs2; break;
+        }
+        if (taken) {
+          next = pc + imm_b;
+          cost = 5;
+        }
+        write = false;
+        break;
+      }
+      case 0x03: {                                                       // loads
+        uint32_t addr = rs1 + imm_i;
+        switch (f3) {
+          case 0: result = (int32_t)(int8_t)load(addr, 1); break;
+          case 1: result = (int32_t)(int16_t)load(addr, 2); break;
+          case 2: result = load(addr, 4); break;
+          case 4: result = load(addr, 1); break;
+          case 5: result = load(addr, 2); break;
+        }
+        cost = 5;
+        break;
+      }
+      case 0x23:                                                         // stores
+        store(rs1 + imm_s, rs2, 1 << f3);
+        cost = 5;
+        write = false;
+        break;
+      case 0x13:                                                         // alu immediate
+      case 0x33: {                                                       // alu
+        bool reg = opcode == 0x33;
+        uint32_t b = reg ? rs2 : (uint32_t)imm_i;
+        uint32_t shamt = b & 31;
+        uint32_t shift_cost = opt.barrel_shifter ? 3 : 3 + shamt;
+        if (reg && f7 == 1) {                                            // RV32M, picorv32 pcpi_mul/div
+          int32_t sa = rs1, sb = rs2;
+          switch (f3) {
+            case 0: result = rs1 * rs2; break;
+            case 1: result = (uint64_t)((int64_t)sa * sb) >> 32; break;
+            case 2: result = (uint64_t)((int64_t)sa * (uint64_t)rs2) >> 32; break;
+            case 3: result = ((uint64_t)rs1 * rs2) >> 32; break;
+            case 4: result = !sb ? ~0u : (sa == INT32_MIN && sb == -1) ? (uint32_t)sa : (uint32_t)(sa / sb); break;
+            case 5: result = !rs2 ? ~0u : rs1 / rs2; break;
+            case 6: result = !sb ? (uint32_t)sa : (sa == INT32_MIN && sb == -1) ? 0 : (uint32_t)(sa % sb); break;
+            case 7: result = !rs2 ? rs1 : rs1 % rs2; break;
+          }
+          cost = 40;
+          break;
+        }
+        switch (f3) {
+          case 0: result = reg && f7 == 0x20 ? rs1 - b : rs1 + b; break;
+          case 1: result = rs1 << shamt; cost = shift_cost; break;
+          case 2: result = (int32_t)rs1 < (int32_t)b; break;
+          case 3: result = rs1 < b; break;
+          case 4: result = rs1 ^ b; break;
+          case 5:
+            result = f7 & 0x20 ? (uint32_t)((int32_t)rs1 >> shamt) : rs1 >> shamt;
+            cost = shift_cost;
+            break;
+          case 6: result = rs1 | b; break;
+          case 7: result = rs1 & b; break;
+        }
+        break;
+      }
+      case 0x0f: write = false; break;                                   // fence
+      case 0x73:                                                         // ecall, ebreak
+      default:
+        if (opcode == 0x0b) {                                            // picorv32 custom
+          cost = 4;
+          uint32_t qs = (insn >> 15) & 3;
+          switch (f7) {
+            case 0: result = q[qs]; break;                               // getq
+            case 1: q[rd & 3] = rs1; write = false; break;               // setq
+            case 2: next = q[0]; irq_active = false; write = false; break;  // retirq
+            case 3: result = irq_mask; irq_mask = rs1; break;            // maskirq
+            case 4:                                                      // waitirq
+              while (!irq_pending) {
+                uint64_t wake = next_wakeup();
+                if (!wake) {
+                  fprintf(stderr, "error: waitirq at 0x%08x with no timer running, nothing can wake it\n", pc);
+                  exit(1);
+                }
+                tick(wake < 0x80000000u ? wake : 0x80000000u);
+              }
+              result = irq_pending;
+              break;
+            case 5: result = timer; timer = rs1; break;                  // timer
+            default: write = false;
+          }
+        } else if (opcode == 0x2b && f3 == 0 && f7 <= 4) {               // hdl/picosoc/pcpi/pcpi_game.v
+          cost = 6;
+          switch (f7) {
+            case 0: result = __builtin_popcount(rs1); break;
+            case 1: result = __builtin_ffs(rs1); break;
+            case 2: result = 0x05200000 | (rs2 & 63) << 8 | (rs1 & 63) << 2; break;
+            case 3: result = (uint64_t)rs1 + rs2 > 0xffff ? 0xffff : rs1 + rs2; break;
+            case 4:
+              result = 0;
+              for (int i = 0; i < 16; i++) result |= (rs1 >> i & 1) << (15 - i);
+              break;
+          }
+        } else {
+          write = false;
+          if (irq_active || (irq_mask & (1 << IRQ_EBREAK))) {
+            halted = true;   // picorv32 traps
+            return;
+          }
+          raise(IRQ_EBREAK);
+        }
+    }
+
+    if (write && rd) x[rd] = result;
+    pc = next;
+    tick(cost);
+  }
+};
+
+// ---------------------------------------------------------------- ordering
+
+// Pettis & Hansen: merge the chains joined by the heaviest edges first
+static std::vector<int> order_functions(const Elf &elf, const Soc &soc) {
+  size_t n = elf.functions.size();
+  std::vector<std::vector<int>> chains(n);
+  std::vector<int> chain_of(n);
+  for (size_t i = 0; i < n; i++) {
+    chains[i].push_back(i);
+    chain_of[i] = i;
+  }
+
+  std::vector<std::pair<uint64_t, std::pair<int, int>>> edges;
+  for (auto &e : soc.edges) edges.push_back(std::make_pair(e.second, e.first));
+  std::sort(edges.begin(), edges.end(),
+            [](const std::pair<uint64_t, std::pair<int, int>> &a,
+               const std::pair<uint64_t, std::pair<int, int>> &b) { return a.first > b.first; });
+
+  for (auto &e : edges) {
+    int a = chain_of[e.second.first], b = chain_of[e.second.second];
+    if (a == b) continue;
+    for (int f : chains[b]) {
+      chains[a].push_back(f);
+      chain_of[f] = a;
+    }
+    chains[b].clear();
+  }
+
+  std::vector<std::pair<uint64_t, int>> hot;
+  for (size_t i = 0; i < n; i++) {
+    if (chains[i].empty()) continue;
+    uint64_t total = 0;
+    for (int f : chains[i]) total += soc.fetches[f];
+    if (total) hot.push_back(std::make_pair(total, i));
+  }
+  std::stable_sort(hot.begin(), hot.end(),
+                   [](const std::pair<uint64_t, int> &a, const std::pair<uint64_t, int> &b) {
+                     return a.first > b.first;
+                   });
+
+  std::vector<int> order;
+  for (auto &h : hot)
+    for (int f : chains[h.second])
+      if (soc.fetches[f]) order.push_back(f);
+  return order;
+}
+
+// where each function would be if the ordered ones came first
+static void assign_new_addresses(Elf &elf, const std::vector<int> &order) {
+  std::vector<bool> placed(elf.functions.size(), false);
+  uint32_t addr = elf.functions[0].addr;
+  for (int f : order) {
+    elf.functions[f].new_addr = addr;
+    addr = (addr + elf.functions[f].size + 3) & ~3u;
+    placed[f] = true;
+  }
+  for (size_t f = 0; f < elf.functions.size(); f++) {
+    if (placed[f]) continue;
+    elf.functions[f].new_addr = addr;
+    addr = (addr + elf.functions[f].size + 3) & ~3u;
+  }
+}
+
+static void report(const char *label, const Soc &soc) {
+  printf("%-7s %10llu insns %12llu clocks %5u frames %10llu flash commands", label,
+         (unsigned long long)soc.insns, (unsigned long long)soc.clocks, soc.frames,
+         (unsigned long long)soc.flash_commands);
+  if (soc.frames) printf(" (%.1f/frame)", (double)soc.flash_commands / soc.frames);
+  printf("\n");
+}
+
+// what a CPU profile costs: clocks per frame, and how many of them the
+// interrupt handlers take
+static void report_cycles(const Soc &soc) {
+  if (!soc.frames) {
+    printf("no frames: the timer interrupt never fired\n");
+    return;
+  }
+  printf("%.0f clocks/frame, %.0f in interrupts (%.1f%%), %.2f clocks/insn\n",
+         (double)soc.clocks / soc.frames, (double)soc.irq_clocks / soc.frames,
+         100.0 * soc.irq_clocks / soc.clocks, (double)soc.clocks / soc.insns);
+}
+
+// bytes below top that no longer hold the paint, scanning up from bottom
+static uint32_t used_below(const Soc &soc, uint32_t bottom, uint32_t top) {
+  uint32_t addr = bottom;
+  while (addr < top && soc.ram_word(addr) == RAM_PAINT) addr += 4;
+  return top - addr;
+}
+
+// bytes above bottom that no longer hold the paint, scanning down from top
+static uint32_t used_above(const Soc &soc, uint32_t bottom, uint32_t top) {
+  uint32_t addr = top;
+  while (addr > bottom && soc.ram_word(addr - 4) == RAM_PAINT) addr -= 4;
+  return addr - bottom;
+}
+
+// high-water marks for the run, as libraries/ramcheck measures them on the
+// board, with a warning for anything that is (nearly) full
+static void report_ram(const Elf &elf, const Soc &soc) {
+  if (elf.heap_start < RAM_DATA || elf.heap_start > RAM_BYTES) {
+    printf("no _heap_start in RAM: not linked with firmware/sections.lds?\n");
+    return;
+  }
+  uint32_t main_stack = used_below(soc, RAM_MAIN_STACK, RAM_DATA);
+  uint32_t irq_stack = used_below(soc, RAM_IRQ_STACK, RAM_MAIN_STACK);
+  uint32_t data = elf.heap_start - RAM_DATA;
+  uint32_t heap = used_above(soc, elf.heap_start, RAM_BYTES);
+  printf("RAM: main stack %u/%u, irq stack %u/%u, data %u + heap %u of %u bytes\n",
+         main_stack, RAM_DATA - RAM_MAIN_STACK, irq_stack, RAM_MAIN_STACK - RAM_IRQ_STACK,
+         data, heap, RAM_BYTES - RAM_DATA);
+
+  if (main_stack == RAM_DATA - RAM_MAIN_STACK) {
+    fprintf(stderr, "warning: the main stack filled its %u bytes, and has probably run into the IRQ stack\n",
+            RAM_DATA - RAM_MAIN_STACK);
+  }
+  if (irq_stack == RAM_MAIN_STACK - RAM_IRQ_STACK) {
+    fprintf(stderr, "warning: the IRQ stack filled its %u bytes, and has probably run into the saved registers\n",
+            RAM_MAIN_STACK - RAM_IRQ_STACK);
+  }
+  if (data + heap > (RAM_BYTES - RAM_DATA) * 15 / 16) {
+    fprintf(stderr, "warning: .ramfunc, .data, .bss and the RAM used above them take %u of %u bytes\n",
+            data + heap, RAM_BYTES - RAM_DATA);
+  }
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+    "usage: %s [options] firmware.elf\n"
+    "  -o file.ld   write the function order to file.ld (default: function_order.ld)\n"
+    "  -n insns     instructions to run (default 20000000)\n"
+    "  -f frames    stop after this many timer interrupts (50Hz frames)\n"
+    "  -s clocks    clocks for a sequential flash read (default 32, dual IO)\n"
+    "  -j clocks    clocks for a flash read command (default 80, dual IO)\n"
+    "  -i value     value read from iomem peripherals (default 0)\n"
+    "  -c mhz       system clock, for the timer peripheral (default 16)\n"
+    "  -u           copy UART output to stderr\n"
+    "  -b           the CPU has a barrel shifter (picorv32 BARREL_SHIFTER)\n"
+    "  -r           only report clocks per frame, don't write file.ld\n"
+    "  -m           only report stack and RAM high-water marks, don't write file.ld\n"
+    "  -v           list the hottest functions and edges\n", prog);
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  opt.max_insns = 20000000;
+  opt.max_frames = 0;
+  opt.flash_seq_clocks = 32;
+  opt.flash_jump_clocks = 80;
+  opt.iomem_value = 0;
+  opt.clk_mhz = 16;
+  opt.uart = false;
+  opt.barrel_shifter = false;
+  const char *out_name = "function_order.ld";
+  bool verbose = false;
+  bool report_only = false;
+  bool ram_only = false;
+
+  int c;
+  while ((c = getopt(argc, argv, "o:n:f:s:j:i:c:ubrmv")) != -1) {
+    switch (c) {
+      case 'o': out_name = optarg; break;
+      case 'n': opt.max_insns = strtoull(optarg, NULL, 0); break;
+      case 'f': opt.max_frames = strtoul(optarg, NULL, 0); break;
+      case 's': opt.flash_seq_clocks = strtoul(optarg, NULL, 0); break;
+      case 'j': opt.flash_jump_clocks = strtoul(optarg, NULL, 0); break;
+      case 'i': opt.iomem_value = strtoul(optarg, NULL, 0); break;
+      case 'c': opt.clk_mhz = strtoul(optarg, NULL, 0); break;
+      case 'u': opt.uart = true; break;
+      case 'b': opt.barrel_shifter = true; break;
+      case 'r': report_only = true; break;
+      case 'm': ram_only = true; break;
+      case 'v': verbose = true; break;
+      default: usage(argv[0]);
+    }
+  }
+  if (optind + 1 != argc || !opt.clk_mhz) usage(argv[0]);
+
+  Elf elf;
+  if (!elf.load(argv[optind])) return 1;
+
+  Soc before(elf, opt, false);
+  before.run();
+  if (before.halted) fprintf(stderr, "warning: the CPU trapped, profile is partial\n");
+
+  if (ram_only) {
+    report_ram(elf, before);
+    return 0;
+  }
+
+  if (report_only) {
+    report("current", before);
+    report_cycles(before);
+    return 0;
+  }
+
+  std::vector<int> order = order_functions(elf, before);
+  assign_new_addresses(elf, order);
+
+  Soc after(elf, opt, true);
+  after.run();
+
+  report("before", before);
+  report("after", after);
+
+  if (verbose) {
+    std::vector<int> by_fetches;
+    for (size_t f = 0; f < elf.functions.size(); f++)
+      if (before.fetches[f]) by_fetches.push_back(f);
+    std::sort(by_fetches.begin(), by_fetches.end(),
+              [&](int a, int b) { return before.fetches[a] > before.fetches[b]; });
+    printf("\nhottest functions (fetches):\n");
+    for (size_t i = 0; i < by_fetches.size() && i < 20; i++)
+      printf("  %10llu  %s\n", (unsigned long long)before.fetches[by_fetches[i]],
+             elf.functions[by_fetches[i]].name.c_str());
+
+    std::vector<std::pair<uint64_t, std::pair<int, int>>> edges;
+    for (auto &e : before.edges) edges.push_back(std::make_pair(e.second, e.first));
+    std::sort(edges.rbegin(), edges.rend());
+    printf("\nheaviest edges (flash commands):\n");
+    for (size_t i = 0; i < edges.size() && i < 20; i++)
+      printf("  %10llu  %s - %s\n", (unsigned long long)edges[i].first,
+             elf.functions[edges[i].second.first].name.c_str(),
+             elf.functions[edges[i].second.second].name.c_str());
+  }
+
+  FILE *out = fopen(out_name, "w");
+  if (!out) {
+    perror(out_name);
+    return 1;
+  }
+  fprintf(out, "/* Generated by tools/xiporder from %s: %llu instructions, %u frames,\n"
+               "   %llu -> %llu flash read commands.  Needs -ffunction-sections. */\n",
+          argv[optind], (unsigned long long)before.insns, before.frames,
+          (unsigned long long)before.flash_commands, (unsigned long long)after.flash_commands);
+  for (int f : order) {
+    const char *name = elf.functions[f].name.c_str();
+    fprintf(out, "*(.text.%s .text.*.%s)\n", name, name);
+  }
+  fclose(out);
+  return 0;
+}